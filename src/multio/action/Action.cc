@@ -54,6 +54,10 @@ void Action::executeNext(message::Message msg) const {
     }
 }
 
+bool Action::acceptsField(const std::string&, const std::string&) const {
+    return true;
+}
+
 std::ostream& operator<<(std::ostream& os, const Action& a) {
     a.print(os);
     return os;
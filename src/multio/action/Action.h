@@ -44,6 +44,10 @@ public:
 
     virtual void execute(message::Message msg) const = 0;
 
+    // Whether a field with this name and category may pass this action. Used to route messages
+    // to the plans that consume them, so it must never reject a field that execute would accept.
+    virtual bool acceptsField(const std::string& name, const std::string& category) const;
+
 protected:
 
     std::string type_;
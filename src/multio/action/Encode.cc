@@ -10,6 +10,7 @@
 
 #include "Encode.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "eckit/exception/Exceptions.h"
@@ -31,9 +32,14 @@ std::unique_ptr<GribEncoder> make_encoder(const eckit::Configuration& config) {
         ASSERT(config.has("template"));
         eckit::AutoStdFile fin{configuration_path() + config.getString("template")};
         int err;
-        return std::unique_ptr<GribEncoder>{
+        std::unique_ptr<GribEncoder> encoder{
             new GribEncoder{codes_handle_new_from_file(nullptr, fin, PRODUCT_GRIB, &err),
-                            config.getString("grid-type", "ORCA1")}};
+                            config.getString("grid-type", "ORCA1"), GridRegistry::instance(),
+                            static_cast<size_t>(config.getUnsigned("handle-cache-size", 64))}};
+        if (config.has("grid-cache")) {
+            encoder->setGridCache(config.getString("grid-cache"));
+        }
+        return encoder;
     }
     else if (format == "none") {
         return nullptr;  // leave message in raw binary format
@@ -42,13 +48,33 @@ std::unique_ptr<GribEncoder> make_encoder(const eckit::Configuration& config) {
         throw eckit::SeriousBug("Encoding format <" + format + "> is not supported");
     }
 }
+std::vector<std::unique_ptr<GribEncoder>> make_encoders(const eckit::Configuration& config,
+                                                      size_t count) {
+    std::vector<std::unique_ptr<GribEncoder>> encoders;
+    for (size_t i = 0; i != count; ++i) {
+        auto encoder = make_encoder(config);
+        if (not encoder) {
+            break;
+        }
+        encoders.push_back(std::move(encoder));
+    }
+    return encoders;
+}
+
+size_t encoding_threads(const eckit::Configuration& config) {
+    return std::max(1L, config.getLong("encoding-threads", 1));
+}
 }  // namespace
 
 using message::Message;
 using message::Peer;
 
 Encode::Encode(const eckit::Configuration& config) :
-    Action{config}, format_{config.getString("format")}, encoder_{make_encoder(config)} {}
+    Action{config},
+    format_{config.getString("format")},
+    encoders_{make_encoders(config, encoding_threads(config))},
+    encoder_{encoders_.empty() ? nullptr : encoders_.front().get()},
+    pool_{encoders_.size() > 1 ? new util::ThreadPool{encoders_.size()} : nullptr} {}
 
 void Encode::execute(Message msg) const {
     util::ScopedTimer timer{timing_};
@@ -67,6 +93,8 @@ void Encode::execute(Message msg) const {
         auto levelCount = msg.metadata().getLong("levelCount", 1);
         if (levelCount == 1) {
             executeNext(encoder_->encodeField(msg));
+        } else if (pool_) {
+            encodeLevels(msg);
         } else {
             auto metadata = msg.metadata();
             auto data = reinterpret_cast<const double*>(msg.payload().data());
@@ -86,8 +114,30 @@ void Encode::execute(Message msg) const {
     }
 }
 
+void Encode::encodeLevels(const Message& msg) const {
+    const auto levelCount = static_cast<size_t>(msg.metadata().getLong("levelCount"));
+    const auto globalSize = msg.globalSize();
+    const auto data = reinterpret_cast<const double*>(msg.payload().data());
+
+    // Levels are encoded concurrently, each worker with its own handles, and passed on in order
+    std::vector<Message> encoded(levelCount);
+    pool_->parallelFor(levelCount, [&](size_t lev, size_t worker) {
+        auto metadata = msg.metadata();
+        metadata.set("level", static_cast<long>(lev + 1));
+        encoded[lev] = encoders_[worker]->encodeField(metadata, data + lev * globalSize, globalSize);
+    });
+
+    for (auto& field : encoded) {
+        executeNext(std::move(field));
+    }
+}
+
 void Encode::print(std::ostream& os) const {
-    os << "Encode(format=" << format_ << ")";
+    os << "Encode(format=" << format_;
+    if (pool_) {
+        os << ", encoding-threads=" << pool_->size();
+    }
+    os << ")";
 }
 
 static ActionBuilder<Encode> EncodeBuilder("Encode");
@@ -17,8 +17,11 @@
 #ifndef multio_server_actions_Encode_H
 #define multio_server_actions_Encode_H
 
+#include <vector>
+
 #include "multio/action/GribEncoder.h"
 #include "multio/action/Action.h"
+#include "multio/util/ThreadPool.h"
 
 namespace eckit {
 class Configuration;
@@ -36,9 +39,15 @@ public:
 private:
     void print(std::ostream& os) const override;
 
+    void encodeLevels(const message::Message& msg) const;
+
     const std::string format_;
 
-    const std::unique_ptr<GribEncoder> encoder_ = nullptr;
+    // One encoder per worker of the pool; the first one also handles the grid information
+    const std::vector<std::unique_ptr<GribEncoder>> encoders_;
+    GribEncoder* const encoder_ = nullptr;
+
+    const std::unique_ptr<util::ThreadPool> pool_;
 };
 
 }  // namespace action
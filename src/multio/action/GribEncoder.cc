@@ -21,7 +21,6 @@
 #include "eckit/exception/Exceptions.h"
 #include "eckit/log/Log.h"
 #include "multio/LibMultio.h"
-#include "multio/action/GridInfo.h"
 
 
 namespace multio {
@@ -31,12 +30,6 @@ using message::Message;
 using message::Peer;
 
 namespace  {
-// TODO: perhaps move this to Mappings as that is already a singleton
-std::map<std::string, std::unique_ptr<GridInfo>>& grids() {
-    static std::map<std::string, std::unique_ptr<GridInfo>> grids_;
-    return grids_;
-}
-
 const std::map<const std::string, const long> ops_to_code{
     {"average", 0}, {"accumulate", 1}, {"maximum", 2}, {"minimum", 3}, {"stddev", 6}};
 
@@ -45,52 +38,65 @@ const std::map<const std::string, const long> category_to_levtype{
 
 }  // namespace
 
-GribEncoder::GribEncoder(codes_handle* handle, const std::string& gridType) :
-    metkit::grib::GribHandle{handle}, gridType_{gridType} {
-    for (auto const& subtype : {"T grid", "U grid", "V grid", "W grid", "F grid"}) {
-        grids().insert(std::make_pair(subtype, std::unique_ptr<GridInfo>{new GridInfo{}}));
-    }
+GribEncoder::GribEncoder(codes_handle* handle, const std::string& gridType, GridRegistry& grids,
+                         size_t maxCachedHandles) :
+    metkit::grib::GribHandle{handle},
+    gridType_{gridType},
+    grids_{grids},
+    maxCachedHandles_{maxCachedHandles} {}
+
+GribEncoder::~GribEncoder() {
+    LOG_DEBUG_LIB(LibMultio) << " -- GRIB handle cache: " << cacheHits_ << " hits, " << cacheMisses_
+                             << " misses, " << handles_.size() << " handles cached" << std::endl;
+}
+
+void GribEncoder::setGridCache(const std::string& directory) {
+    gridCache_ = directory;
 }
 
 bool GribEncoder::gridInfoReady(const std::string& subtype) const {
-    return grids().at(subtype)->hashExists();
+    return grids_.ready(subtype);
 }
 
 bool GribEncoder::setGridInfo(message::Message msg) {
-    ASSERT(not gridInfoReady(msg.domain())); // Panic check during development
-
     ASSERT(coordSet_.find(msg.metadata().getString("nemoParam")) != end(coordSet_));
 
-    grids().at(msg.domain())->setSubtype(msg.domain());
-
-    if (msg.metadata().getString("nemoParam").substr(0, 3) == "lat") {
-        grids().at(msg.domain())->setLatitudes(msg);
+    if (gridCache_.empty()) {
+        return grids_.addCoordinates(msg);
     }
 
-    if (msg.metadata().getString("nemoParam").substr(0, 3) == "lon") {
-        grids().at(msg.domain())->setLongitudes(msg);
-    }
-
-    return grids().at(msg.domain())->computeHashIfCan();
+    auto cacheFile = gridCache_ + "/" + gridType_ + "_" + msg.domain().substr(0, 1) + "_" +
+                     std::to_string(msg.globalSize()) + ".grid";
+    return grids_.addCoordinates(msg, cacheFile);
 }
 
 void GribEncoder::setOceanMetadata(const message::Metadata& metadata) {
+    current_ = &cachedHandle(metadata);
+
+    // Only the keys that vary within a field type are set per field
+    setValue("step", metadata.getLong("step"));
+    setValue("level", metadata.getLong("level"));
+
+    // TODO: Nemo should set this at the beginning of the run
+    setValue("date", metadata.getLong("date"));
+
+    // Statistics field
+    if (metadata.has("operation") and metadata.getString("operation") != "instant") {
+        setValue("stepRange", metadata.getString("stepRange"));
+    }
+}
+
+void GribEncoder::setFieldTypeMetadata(const message::Metadata& metadata) {
     // setCommonMetadata
     setValue("expver", "xxxx");
     setValue("class", "rd");
     setValue("stream", "oper");
     setValue("type", "fc");
     setValue("levtype", category_to_levtype.at(metadata.getString("category")));
-    setValue("step", metadata.getLong("step"));
-    setValue("level", metadata.getLong("level"));
-
-    // TODO: Nemo should set this at the beginning of the run
-    setValue("date", metadata.getLong("date"));
 
     // Statistics field
     if (metadata.has("operation") and metadata.getString("operation") != "instant") {
         setValue("typeOfStatisticalProcessing", ops_to_code.at(metadata.getString("operation")));
-        setValue("stepRange", metadata.getString("stepRange"));
     }
 
     // setDomainDimensions
@@ -106,23 +112,59 @@ void GribEncoder::setOceanMetadata(const message::Metadata& metadata) {
     const auto& gridSubtype = metadata.getString("gridSubtype");
     setValue("unstructuredGridSubtype", gridSubtype.substr(0, 1));
 
-    setValue("uuidOfHGrid", grids().at(gridSubtype)->hashValue());
+    setValue("uuidOfHGrid", grids_.gridInfo(gridSubtype).hashValue());
+}
+
+GribEncoder::PreparedHandle& GribEncoder::cachedHandle(const message::Metadata& metadata) {
+    auto key = std::to_string(metadata.getLong("param")) + "/" + metadata.getString("category") +
+               "/" + metadata.getString("gridSubtype") + "/" +
+               metadata.getString("operation", "instant") + "/" +
+               std::to_string(metadata.getLong("globalSize"));
+
+    auto it = handleIndex_.find(key);
+    if (it != end(handleIndex_)) {
+        ++cacheHits_;
+        handles_.splice(begin(handles_), handles_, it->second);
+        return handles_.front().second;
+    }
+
+    ++cacheMisses_;
+    if (not handles_.empty() && handles_.size() >= maxCachedHandles_) {
+        handleIndex_.erase(handles_.back().first);
+        handles_.pop_back();
+    }
+
+    handles_.emplace_front(key, PreparedHandle{});
+    handleIndex_[key] = begin(handles_);
+
+    auto& prepared = handles_.front().second;
+    prepared.handle.reset(this->clone());
+    ASSERT(prepared.handle);
+
+    current_ = &prepared;
+    setFieldTypeMetadata(metadata);
+
+    return prepared;
+}
+
+codes_handle* GribEncoder::currentHandle() const {
+    return current_ ? current_->handle->raw() : raw();
 }
 
 void GribEncoder::setValue(const std::string& key, long value) {
     LOG_DEBUG_LIB(LibMultio) << "*** Setting value " << value << " for key " << key << std::endl;
-    CODES_CHECK(codes_set_long(raw(), key.c_str(), value), NULL);
+    CODES_CHECK(codes_set_long(currentHandle(), key.c_str(), value), NULL);
 }
 
 void GribEncoder::setValue(const std::string& key, double value) {
     LOG_DEBUG_LIB(LibMultio) << "*** Setting value " << value << " for key " << key << std::endl;
-    CODES_CHECK(codes_set_double(raw(), key.c_str(), value), NULL);
+    CODES_CHECK(codes_set_double(currentHandle(), key.c_str(), value), NULL);
 }
 
 void GribEncoder::setValue(const std::string& key, const std::string& value) {
     LOG_DEBUG_LIB(LibMultio) << "*** Setting value " << value << " for key " << key << std::endl;
     size_t sz = value.size();
-    CODES_CHECK(codes_set_string(raw(), key.c_str(), value.c_str(), &sz), NULL);
+    CODES_CHECK(codes_set_string(currentHandle(), key.c_str(), value.c_str(), &sz), NULL);
 }
 
 void GribEncoder::setValue(const std::string& key, const unsigned char* value) {
@@ -134,11 +176,11 @@ void GribEncoder::setValue(const std::string& key, const unsigned char* value) {
     LOG_DEBUG_LIB(LibMultio) << "*** Setting value " << oss.str() << " for key " << key
                              << std::endl;
     size_t sz = DIGEST_LENGTH;
-    CODES_CHECK(codes_set_bytes(raw(), key.c_str(), value, &sz), NULL);
+    CODES_CHECK(codes_set_bytes(currentHandle(), key.c_str(), value, &sz), NULL);
 }
 
 message::Message GribEncoder::encodeLatitudes(const std::string& subtype) {
-    auto msg = grids().at(subtype)->latitudes();
+    auto msg = grids_.gridInfo(subtype).latitudes();
 
     setOceanMetadata(msg.metadata());
 
@@ -146,7 +188,7 @@ message::Message GribEncoder::encodeLatitudes(const std::string& subtype) {
 }
 
 message::Message GribEncoder::encodeLongitudes(const std::string& subtype) {
-    auto msg = grids().at(subtype)->longitudes();
+    auto msg = grids_.gridInfo(subtype).longitudes();
 
     setOceanMetadata(msg.metadata());
 
@@ -166,21 +208,85 @@ message::Message GribEncoder::encodeField(const message::Metadata& md, const dou
 
 message::Message GribEncoder::setFieldValues(const message::Message& msg) {
     auto beg = reinterpret_cast<const double*>(msg.payload().data());
-    this->setDataValues(beg, msg.globalSize());
+    return setFieldValues(beg, msg.globalSize());
+}
+
+message::Message GribEncoder::setFieldValues(const double* values, size_t count) {
+    eckit::Buffer buf;
+    if (not packNatively(values, count, buf)) {
+        auto& handle = *current_->handle;
+        handle.setDataValues(values, count);
 
-    eckit::Buffer buf{this->length()};
-    this->write(buf);
+        buf = eckit::Buffer{handle.length()};
+        handle.write(buf);
+
+        checkNativePacking();
+    }
 
     return Message{Message::Header{Message::Tag::Grib, Peer{}, Peer{}}, std::move(buf)};
 }
 
-message::Message GribEncoder::setFieldValues(const double* values, size_t count) {
-    this->setDataValues(values, count);
+bool GribEncoder::packNatively(const double* values, size_t count, eckit::Buffer& buf) {
+    auto& packing = current_->packing;
+    if (not packing || not packing->computeParameters(values, count)) {
+        return false;
+    }
 
-    eckit::Buffer buf{this->length()};
-    this->write(buf);
+    auto h = current_->handle->raw();
 
-    return Message{Message::Header{Message::Tag::Grib, Peer{}, Peer{}}, std::move(buf)};
+    long section5 = 0;
+    long section7 = 0;
+    CODES_CHECK(codes_get_long(h, "offsetSection5", &section5), NULL);
+    CODES_CHECK(codes_get_long(h, "offsetSection7", &section7), NULL);
+
+    const void* message = nullptr;
+    size_t length = 0;
+    CODES_CHECK(codes_get_message(h, &message, &length), NULL);
+
+    // Section 7 header, packed values and the end section "7777"
+    const size_t dataOffset = section7 + 5;
+    if (dataOffset + packing->packedLength(count) + 4 != length) {
+        packing.reset();
+        return false;
+    }
+
+    buf = eckit::Buffer{length};
+    auto out = reinterpret_cast<unsigned char*>(buf.data());
+
+    std::memcpy(out, message, dataOffset);
+    packing->encodeSection5(out + section5);
+    packing->pack(values, count, out + dataOffset);
+    std::memcpy(out + length - 4, static_cast<const unsigned char*>(message) + length - 4, 4);
+
+    return true;
+}
+
+void GribEncoder::checkNativePacking() {
+    auto h = current_->handle->raw();
+    current_->packing.reset();
+
+    long edition = 0;
+    long bitmapPresent = 0;
+    long bitsPerValue = 0;
+    long binaryScaleFactor = 0;
+    long decimalScaleFactor = 0;
+    CODES_CHECK(codes_get_long(h, "edition", &edition), NULL);
+    CODES_CHECK(codes_get_long(h, "bitmapPresent", &bitmapPresent), NULL);
+    CODES_CHECK(codes_get_long(h, "bitsPerValue", &bitsPerValue), NULL);
+    CODES_CHECK(codes_get_long(h, "binaryScaleFactor", &binaryScaleFactor), NULL);
+    CODES_CHECK(codes_get_long(h, "decimalScaleFactor", &decimalScaleFactor), NULL);
+
+    char packingType[64];
+    size_t sz = sizeof(packingType);
+    CODES_CHECK(codes_get_string(h, "packingType", packingType, &sz), NULL);
+
+    // ecCodes derives the bits per value from a preset decimal scale factor in that case instead
+    bool presetDecimalScaling = (binaryScaleFactor == 0 && decimalScaleFactor != 0);
+
+    if (edition == 2 && bitmapPresent == 0 && std::string{packingType} == "grid_simple" &&
+        0 < bitsPerValue && bitsPerValue <= 32 && not presetDecimalScaling) {
+        current_->packing.reset(new SimplePacking{bitsPerValue});
+    }
 }
 
 }  // namespace action
@@ -15,9 +15,18 @@
 #ifndef multio_server_actions_GribEncoder_H
 #define multio_server_actions_GribEncoder_H
 
+#include <list>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
 #include "eccodes.h"
 
+#include "eckit/io/Buffer.h"
+
 #include "metkit/codes/GribHandle.h"
+#include "multio/action/GridRegistry.h"
+#include "multio/action/SimplePacking.h"
 #include "multio/message/Message.h"
 
 namespace multio {
@@ -25,7 +34,12 @@ namespace action {
 
 class GribEncoder : public metkit::grib::GribHandle {
 public:
-    GribEncoder(codes_handle* handle, const std::string& gridType);
+    GribEncoder(codes_handle* handle, const std::string& gridType, GridRegistry& grids,
+                size_t maxCachedHandles = 64);
+    ~GribEncoder();
+
+    // Directory in which the hashes of the grids are kept across runs
+    void setGridCache(const std::string& directory);
 
     bool gridInfoReady(const std::string& subtype) const;
     bool setGridInfo(message::Message msg);
@@ -42,12 +56,44 @@ public:
     message::Message encodeField(const message::Metadata& md, const double* data, size_t sz);
 
 private:
+    struct PreparedHandle {
+        std::unique_ptr<metkit::grib::GribHandle> handle;
+        // Set once ecCodes has encoded a field with simple packing into this handle
+        std::unique_ptr<SimplePacking> packing;
+    };
+
+    using HandleList = std::list<std::pair<std::string, PreparedHandle>>;
+
     void setOceanMetadata(const message::Metadata& metadata);
+    void setFieldTypeMetadata(const message::Metadata& metadata);
+
+    PreparedHandle& cachedHandle(const message::Metadata& metadata);
+
+    codes_handle* currentHandle() const;
+
+    bool packNatively(const double* values, size_t count, eckit::Buffer& buf);
+    void checkNativePacking();
+
     message::Message setFieldValues(const  message::Message& msg);
     message::Message setFieldValues(const double* values, size_t count);
 
     const std::string gridType_;
 
+    GridRegistry& grids_;
+    std::string gridCache_;
+
+    // Clones of the template with the keys that are constant for a (param, levtype, gridSubtype,
+    // operation) already set, most recently used first
+    HandleList handles_;
+    std::unordered_map<std::string, HandleList::iterator> handleIndex_;
+    const size_t maxCachedHandles_;
+
+    size_t cacheHits_ = 0;
+    size_t cacheMisses_ = 0;
+
+    // Handle that setValue and setFieldValues act upon
+    PreparedHandle* current_ = nullptr;
+
     std::set<std::string> coordSet_{"lat_T", "lon_T", "lat_U", "lon_U", "lat_V",
                                     "lon_V", "lat_W", "lon_W", "lat_F", "lon_F"};
 };
@@ -14,9 +14,15 @@
 
 #include "GridInfo.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+
+#include <unistd.h>
 
 #include "eckit/exception/Exceptions.h"
 #include "eckit/system/SystemInfo.h"
@@ -28,16 +34,19 @@ namespace multio {
 namespace action {
 
 namespace  {
-template <typename T>
-eckit::Buffer byteswap(const eckit::Buffer& buf) {
-    eckit::Buffer ret{static_cast<const char*>(buf), buf.size()};  // Create a local copy
-
-    auto ret_ptr = reinterpret_cast<T*>(ret.data());
-    auto ret_sz = buf.size() / sizeof(T);
-
-    eckit::byteswap(ret_ptr, ret_sz);
-
-    return ret;
+// Coordinates are byteswapped and compared in blocks of this many bytes
+const size_t blockSize = 64 * 1024;
+
+bool sameContents(std::istream& in, const eckit::Buffer& buf) {
+    std::vector<char> block(std::min(blockSize, buf.size()));
+    auto data = static_cast<const char*>(buf.data());
+    for (size_t offset = 0; offset < buf.size(); offset += block.size()) {
+        auto n = std::min(block.size(), buf.size() - offset);
+        if (not in.read(block.data(), n) || std::memcmp(block.data(), data + offset, n) != 0) {
+            return false;
+        }
+    }
+    return true;
 }
 }  // namespace
 
@@ -51,16 +60,28 @@ void GridInfo::setSubtype(const std::string& subtype) {
     ASSERT(gridSubtype_ == subtype);
 }
 
+void GridInfo::setCacheFile(const std::string& path) {
+    cacheFile_ = path;
+}
+
 void GridInfo::setLatitudes(message::Message msg) {
     ASSERT(latitudes_.size() == 0);
 
     latitudes_ = msg;
+
+    if (cacheFile_.empty()) {
+        hashAvailable();
+    }
 }
 
 void GridInfo::setLongitudes(message::Message msg) {
     ASSERT(longitudes_.size() == 0);
 
     longitudes_ = msg;
+
+    if (cacheFile_.empty()) {
+        hashAvailable();
+    }
 }
 
 const message::Message& GridInfo::latitudes() const {
@@ -78,9 +99,13 @@ bool GridInfo::computeHashIfCan() {
 
     ASSERT(not gridSubtype_.empty()); // Paranoia -- this should never happen
 
-    hashFunction_.add(gridSubtype_.c_str(), gridSubtype_.size());
-    addToHash(latitudes_.payload());
-    addToHash(longitudes_.payload());
+    if (not cacheFile_.empty() && readCache()) {
+        LOG_DEBUG_LIB(LibMultio) << "*** Reusing hash value from " << cacheFile_ << std::endl;
+        return true;
+    }
+
+    hashAvailable();
+    ASSERT(latitudesHashed_ && longitudesHashed_);
 
     hashValue_.reset(new unsigned char[DIGEST_LENGTH]);
     hashFunction_.numericalDigest(hashValue_.get());
@@ -93,6 +118,10 @@ bool GridInfo::computeHashIfCan() {
     }
     LOG_DEBUG_LIB(LibMultio) << oss.str() << std::endl;
 
+    if (not cacheFile_.empty()) {
+        writeCache();
+    }
+
     return true;
 }
 
@@ -104,13 +133,93 @@ const unsigned char* GridInfo::hashValue() const {
     return hashValue_.get();
 }
 
-void GridInfo::addToHash(const eckit::Buffer& buf) {
-    if (eckit::system::SystemInfo::isBigEndian()) {
-        auto swappedBuf = byteswap<double>(buf);
+void GridInfo::hashAvailable() {
+    if (gridSubtype_.empty()) {
+        return;
+    }
+
+    if (not subtypeHashed_) {
+        hashFunction_.add(gridSubtype_.c_str(), gridSubtype_.size());
+        subtypeHashed_ = true;
+    }
+
+    if (not latitudesHashed_ && latitudes_.payload().size() != 0) {
+        addToHash(latitudes_.payload());
+        latitudesHashed_ = true;
+    }
+
+    // Longitudes follow the latitudes in the hash, whichever arrived first
+    if (latitudesHashed_ && not longitudesHashed_ && longitudes_.payload().size() != 0) {
+        addToHash(longitudes_.payload());
+        longitudesHashed_ = true;
+    }
+}
 
-        hashFunction_.add(swappedBuf.data(), swappedBuf.size());
-    } else {
+void GridInfo::addToHash(const eckit::Buffer& buf) {
+    if (not eckit::system::SystemInfo::isBigEndian()) {
         hashFunction_.add(buf.data(), buf.size());
+        return;
+    }
+
+    // Swap a block at a time rather than copying the whole payload
+    const size_t count = buf.size() / sizeof(double);
+    std::vector<double> block(std::min(count, blockSize / sizeof(double)));
+
+    auto data = static_cast<const char*>(buf.data());
+    for (size_t offset = 0; offset < count; offset += block.size()) {
+        auto n = std::min(block.size(), count - offset);
+        std::memcpy(block.data(), data + offset * sizeof(double), n * sizeof(double));
+        eckit::byteswap(block.data(), n);
+        hashFunction_.add(block.data(), n * sizeof(double));
+    }
+}
+
+bool GridInfo::readCache() {
+    std::ifstream in{cacheFile_, std::ios::binary};
+    if (not in) {
+        return false;
+    }
+
+    const auto expected = DIGEST_LENGTH + latitudes_.payload().size() + longitudes_.payload().size();
+    in.seekg(0, std::ios::end);
+    if (static_cast<size_t>(in.tellg()) != expected) {
+        return false;
+    }
+    in.seekg(0, std::ios::beg);
+
+    std::unique_ptr<unsigned char[]> digest{new unsigned char[DIGEST_LENGTH]};
+    if (not in.read(reinterpret_cast<char*>(digest.get()), DIGEST_LENGTH)) {
+        return false;
+    }
+
+    if (not sameContents(in, latitudes_.payload()) || not sameContents(in, longitudes_.payload())) {
+        LOG_DEBUG_LIB(LibMultio) << "*** Coordinates differ from " << cacheFile_ << std::endl;
+        return false;
+    }
+
+    hashValue_ = std::move(digest);
+    return true;
+}
+
+void GridInfo::writeCache() const {
+    // Several servers may write the same entry: write aside and rename into place
+    const auto tmp = cacheFile_ + "." + std::to_string(::getpid());
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(hashValue_.get()), DIGEST_LENGTH);
+        out.write(static_cast<const char*>(latitudes_.payload().data()), latitudes_.payload().size());
+        out.write(static_cast<const char*>(longitudes_.payload().data()),
+                  longitudes_.payload().size());
+        if (not out) {
+            eckit::Log::warning() << "Could not write grid cache " << tmp << std::endl;
+            std::remove(tmp.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(tmp.c_str(), cacheFile_.c_str()) != 0) {
+        eckit::Log::warning() << "Could not write grid cache " << cacheFile_ << std::endl;
+        std::remove(tmp.c_str());
     }
 }
 
@@ -24,11 +24,15 @@ namespace action {
 
 #define DIGEST_LENGTH MD5_DIGEST_LENGTH
 
+// Coordinates are hashed as they arrive: the subtype, then the latitudes, then the longitudes.
+// With a cache file, the hash stored by an earlier run is reused if the coordinates are unchanged.
+
 class GridInfo {
 public:
     GridInfo();
 
     void setSubtype(const std::string& subtype);
+    void setCacheFile(const std::string& path);
     void setLatitudes(message::Message msg);
     void setLongitudes(message::Message msg);
 
@@ -42,12 +46,22 @@ public:
 
 private:
 
+    void hashAvailable();
     void addToHash(const eckit::Buffer& buf);
 
+    bool readCache();
+    void writeCache() const;
+
     message::Message latitudes_;
     message::Message longitudes_;
     std::string gridSubtype_;
 
+    bool subtypeHashed_ = false;
+    bool latitudesHashed_ = false;
+    bool longitudesHashed_ = false;
+
+    std::string cacheFile_;
+
     std::unique_ptr<unsigned char[]> hashValue_ = nullptr;
     eckit::MD5 hashFunction_;
 };
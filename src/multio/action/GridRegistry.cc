@@ -0,0 +1,79 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "GridRegistry.h"
+
+#include "eckit/exception/Exceptions.h"
+
+namespace multio {
+namespace action {
+
+GridRegistry::GridRegistry() {
+    for (auto const& subtype : {"T grid", "U grid", "V grid", "W grid", "F grid"}) {
+        entries_.emplace(subtype, std::unique_ptr<Entry>{new Entry{}});
+    }
+}
+
+GridRegistry& GridRegistry::instance() {
+    static GridRegistry singleton;
+    return singleton;
+}
+
+bool GridRegistry::ready(const std::string& subtype) const {
+    return entry(subtype).ready.load(std::memory_order_acquire);
+}
+
+bool GridRegistry::addCoordinates(message::Message msg, const std::string& cacheFile) {
+    auto& e = entry(msg.domain());
+
+    std::lock_guard<std::mutex> lock{e.mutex};
+
+    ASSERT(not e.ready);  // Panic check during development
+
+    e.info.setSubtype(msg.domain());
+    if (not cacheFile.empty()) {
+        e.info.setCacheFile(cacheFile);
+    }
+
+    const auto& param = msg.metadata().getString("nemoParam");
+    if (param.substr(0, 3) == "lat") {
+        e.info.setLatitudes(msg);
+    }
+
+    if (param.substr(0, 3) == "lon") {
+        e.info.setLongitudes(msg);
+    }
+
+    if (not e.info.computeHashIfCan()) {
+        return false;
+    }
+
+    e.ready.store(true, std::memory_order_release);
+    return true;
+}
+
+const GridInfo& GridRegistry::gridInfo(const std::string& subtype) const {
+    const auto& e = entry(subtype);
+    ASSERT(e.ready.load(std::memory_order_acquire));
+    return e.info;
+}
+
+GridRegistry::Entry& GridRegistry::entry(const std::string& subtype) const {
+    auto it = entries_.find(subtype);
+    if (it == end(entries_)) {
+        throw eckit::SeriousBug("Unknown grid subtype: " + subtype, Here());
+    }
+    return *it->second;
+}
+
+}  // namespace action
+}  // namespace multio
@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_server_actions_GridRegistry_H
+#define multio_server_actions_GridRegistry_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "multio/action/GridInfo.h"
+
+namespace multio {
+namespace action {
+
+// Grid information shared by all encoders of the server. Coordinates only reach the plan that
+// selects them, while every plan's encoder needs the resulting hashes.
+//
+// The set of subtypes is fixed at construction, so lookups need no lock. Each subtype is
+// filled in under its own mutex and is read-only once its hash has been computed.
+
+class GridRegistry {
+public:  // methods
+    GridRegistry();
+
+    GridRegistry(const GridRegistry& rhs) = delete;
+    GridRegistry& operator=(const GridRegistry& rhs) = delete;
+
+    static GridRegistry& instance();
+
+    bool ready(const std::string& subtype) const;
+
+    // Returns true for the call that completes the coordinates of a subtype. A non-empty cache
+    // file lets the hash be reused from, and stored for, other runs on the same grid.
+    bool addCoordinates(message::Message msg, const std::string& cacheFile = "");
+
+    // Only valid once ready(subtype)
+    const GridInfo& gridInfo(const std::string& subtype) const;
+
+private:  // members
+    struct Entry {
+        std::mutex mutex;
+        GridInfo info;
+        std::atomic<bool> ready{false};
+    };
+
+    Entry& entry(const std::string& subtype) const;
+
+    std::map<std::string, std::unique_ptr<Entry>> entries_;
+};
+
+}  // namespace action
+}  // namespace multio
+
+#endif
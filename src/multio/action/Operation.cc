@@ -44,6 +44,13 @@ void Instant::update(const double* val, long sz) {
                              << std::endl;
 }
 
+void Instant::merge(const Operation& partial) {
+    const auto& other = dynamic_cast<const Instant&>(partial);
+    ASSERT(values_.size() == other.values_.size());
+
+    values_ = other.values_;
+}
+
 void Instant::print(std::ostream& os) const {
     os << "Operation(instant)";
 }
@@ -65,9 +72,11 @@ const std::vector<double>& Average::compute() {
 }
 
 void Average::update(const double* val, long sz) {
-    std::ostringstream os;
-    os << "Expected size: " << values_.size() << " -- actual size: " << sz << std::endl;
-    ASSERT_MSG(values_.size() == static_cast<size_t>(sz), os.str());
+    if (values_.size() != static_cast<size_t>(sz)) {
+        std::ostringstream os;
+        os << "Expected size: " << values_.size() << " -- actual size: " << sz << std::endl;
+        ASSERT_MSG(values_.size() == static_cast<size_t>(sz), os.str());
+    }
 
     for (auto& v : values_) {
         v += *val++;
@@ -75,6 +84,25 @@ void Average::update(const double* val, long sz) {
     ++count_;
 }
 
+void Average::merge(const Operation& partial) {
+    const auto& other = dynamic_cast<const Average&>(partial);
+    ASSERT(values_.size() == other.values_.size());
+
+    auto val = other.values_.begin();
+    for (auto& v : values_) {
+        v += *val++;
+    }
+    count_ += other.count_;
+}
+
+long Average::count() const {
+    return count_;
+}
+
+const std::vector<double>& Average::sums() const {
+    return values_;
+}
+
 void Average::print(std::ostream& os) const {
     os << "Operation(average)";
 }
@@ -100,6 +128,13 @@ void Minimum::update(const double* val, long sz) {
                              << std::endl;
 }
 
+void Minimum::merge(const Operation& partial) {
+    const auto& other = dynamic_cast<const Minimum&>(partial);
+    ASSERT(values_.size() == other.values_.size());
+
+    update(other.values_.data(), other.values_.size());
+}
+
 void Minimum::print(std::ostream& os) const {
     os << "Operation(minimum)";
 }
@@ -125,6 +160,13 @@ void Maximum::update(const double* val, long sz) {
                              << std::endl;
 }
 
+void Maximum::merge(const Operation& partial) {
+    const auto& other = dynamic_cast<const Maximum&>(partial);
+    ASSERT(values_.size() == other.values_.size());
+
+    update(other.values_.data(), other.values_.size());
+}
+
 void Maximum::print(std::ostream& os) const {
     os << "Operation(maximum)";
 }
@@ -149,6 +191,13 @@ void Accumulate::update(const double* val, long sz) {
                              << std::endl;
 }
 
+void Accumulate::merge(const Operation& partial) {
+    const auto& other = dynamic_cast<const Accumulate&>(partial);
+    ASSERT(values_.size() == other.values_.size());
+
+    update(other.values_.data(), other.values_.size());
+}
+
 void Accumulate::print(std::ostream& os) const {
     os << "Operation(accumulate)";
 }
@@ -18,6 +18,9 @@ public:
     virtual const std::vector<double>& compute() = 0;
     virtual void update(const double* val, long sz) = 0;
 
+    // Combine the partial (not yet computed) result of the same operation over a sub-period
+    virtual void merge(const Operation& partial) = 0;
+
     virtual ~Operation() = default;
 
 protected:
@@ -39,6 +42,8 @@ public:
 
     void update(const double* val, long sz) override;
 
+    void merge(const Operation& partial) override;
+
 private:
     void print(std::ostream &os) const override;
 };
@@ -53,6 +58,11 @@ public:
 
     void update(const double* val, long sz) override;
 
+    void merge(const Operation& partial) override;
+
+    long count() const;
+    const std::vector<double>& sums() const;
+
 private:
     void print(std::ostream &os) const override;
 };
@@ -65,6 +75,8 @@ public:
 
     void update(const double* val, long sz) override;
 
+    void merge(const Operation& partial) override;
+
 private:
     void print(std::ostream &os) const override;
 };
@@ -77,6 +89,8 @@ public:
 
     void update(const double* val, long sz) override;
 
+    void merge(const Operation& partial) override;
+
 private:
     void print(std::ostream &os) const override;
 };
@@ -89,6 +103,8 @@ public:
 
     void update(const double* val, long sz) override;
 
+    void merge(const Operation& partial) override;
+
 private:
     void print(std::ostream &os) const override;
 };
@@ -37,36 +37,34 @@ std::ostream& operator<<(std::ostream& os, const DatePeriod& a) {
 //-------------------------------------------------------------------------------------------------
 
 DateTimePeriod::DateTimePeriod(const eckit::DateTime& startPoint, eckit::Second duration) :
-    startPoint_{startPoint}, endPoint_{startPoint_ + duration} {}
+    reference_{startPoint}, startPoint_{0}, endPoint_{static_cast<long>(duration)} {}
 
 DateTimePeriod::DateTimePeriod(const eckit::DateTime& startPoint, const eckit::DateTime& endPoint) :
-    startPoint_{startPoint}, endPoint_{endPoint} {}
+    reference_{startPoint}, startPoint_{0}, endPoint_{static_cast<long>(endPoint - startPoint)} {}
 
-void DateTimePeriod::reset(const eckit::DateTime& current) {
+void DateTimePeriod::reset(long current) {
     auto duration = endPoint_ - startPoint_;
     startPoint_ = current;
     endPoint_ = startPoint_ + duration;
 }
 
-void DateTimePeriod::reset(const eckit::DateTime& startPoint, const eckit::DateTime& endPoint) {
-    startPoint_ = startPoint;
-    endPoint_ = endPoint;
-}
-
-bool DateTimePeriod::isWithin(const eckit::DateTime& dt) {
-    ASSERT(startPoint_ <= dt);
-    auto ret = (dt <= endPoint() + eckit::Second{1.0});
-    LOG_DEBUG_LIB(LibMultio) << " ------ Is " << dt << " within " << *this << "? -- "
+bool DateTimePeriod::isWithin(long seconds) const {
+    ASSERT(startPoint_ <= seconds);
+    // Keeps the one second of tolerance the date-time comparison had, for steps that land just
+    // past the end of the period
+    auto ret = (seconds <= endPoint() + 1);
+    LOG_DEBUG_LIB(LibMultio) << " ------ Is " << seconds << "s within " << *this << "? -- "
                              << (ret ? "yes" : "no") << std::endl;
     return ret;
 }
 
-eckit::DateTime DateTimePeriod::endPoint() const {
+long DateTimePeriod::endPoint() const {
     return endPoint_;
 }
 
 void DateTimePeriod::print(std::ostream& os) const {
-    os << "Period(" << startPoint_ << " to " << endPoint() << ")";
+    os << "Period(" << reference_ + static_cast<eckit::Second>(startPoint_) << " to "
+       << reference_ + static_cast<eckit::Second>(endPoint()) << ")";
 }
 
 std::ostream& operator<<(std::ostream& os, const DateTimePeriod& a) {
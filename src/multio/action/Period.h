@@ -25,21 +25,24 @@ private:
 
 };
 
+// Period membership is decided on integer seconds since the reference date-time, which is the
+// start of the run; the date-time objects are only materialised for printing
 class DateTimePeriod {
 public:
     DateTimePeriod(const eckit::DateTime& startPoint, eckit::Second duration);
     DateTimePeriod(const eckit::DateTime& startPoint, const eckit::DateTime& endPoint);
 
-    void reset(const eckit::DateTime& current);
-    void reset(const eckit::DateTime& startPoint, const eckit::DateTime& endPoint);
+    void reset(long current);
 
-    bool isWithin(const eckit::DateTime& dt);
+    bool isWithin(long seconds) const;
 
 private:
-    eckit::DateTime startPoint_;
-    eckit::DateTime endPoint_;
+    eckit::DateTime reference_;
 
-    eckit::DateTime endPoint() const;
+    long startPoint_;
+    long endPoint_;
+
+    long endPoint() const;
     void print(std::ostream& os) const;
 
     friend std::ostream& operator<<(std::ostream& os, const DateTimePeriod& a);
@@ -69,5 +69,9 @@ void Plan::process(message::Message msg) {
     root_->execute(msg);
 }
 
+bool Plan::acceptsField(const std::string& name, const std::string& category) const {
+    return root_->acceptsField(name, category);
+}
+
 }  // namespace action
 }  // namespace multio
@@ -40,6 +40,8 @@ public:
 
     void process(message::Message msg);
 
+    bool acceptsField(const std::string& name, const std::string& category) const;
+
 private:
 
     std::string name_;
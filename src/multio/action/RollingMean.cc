@@ -0,0 +1,73 @@
+
+#include "RollingMean.h"
+
+#include <iostream>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "multio/LibMultio.h"
+#include "multio/action/Operation.h"
+
+namespace multio {
+namespace action {
+
+RollingMean::RollingMean(long window, long sz) :
+    window_{window},
+    sums_(window, std::vector<double>(sz)),
+    counts_(window, 0),
+    startSteps_(window, 0),
+    total_(sz),
+    values_(sz) {
+    ASSERT(window_ > 0);
+}
+
+void RollingMean::push(const Average& partial, long startStep, long endStep) {
+    const auto& sums = partial.sums();
+    ASSERT(sums.size() == total_.size());
+
+    auto& slot = sums_[next_];
+    for (size_t ii = 0; ii != total_.size(); ++ii) {
+        total_[ii] += sums[ii] - slot[ii];
+        slot[ii] = sums[ii];
+    }
+
+    totalCount_ += partial.count() - counts_[next_];
+    counts_[next_] = partial.count();
+    startSteps_[next_] = startStep;
+    endStep_ = endStep;
+
+    next_ = (next_ + 1) % sums_.size();
+    filled_ = std::min(filled_ + 1, sums_.size());
+
+    LOG_DEBUG_LIB(LibMultio) << " *** Pushed partial sums into " << *this << std::endl;
+}
+
+bool RollingMean::full() const {
+    return filled_ == sums_.size();
+}
+
+const std::vector<double>& RollingMean::compute() {
+    ASSERT(totalCount_ > 0);
+    for (size_t ii = 0; ii != total_.size(); ++ii) {
+        values_[ii] = total_[ii] / static_cast<double>(totalCount_);
+    }
+    return values_;
+}
+
+std::string RollingMean::stepRange() const {
+    // Once full, the slot to be overwritten next holds the oldest period in the window
+    auto oldest = full() ? next_ : 0;
+    return std::to_string(startSteps_[oldest]) + "-" + std::to_string(endStep_);
+}
+
+long RollingMean::window() const {
+    return window_;
+}
+
+void RollingMean::print(std::ostream& os) const {
+    os << "RollingMean(window=" << window_ << ", filled=" << filled_ << ", count=" << totalCount_
+       << ")";
+}
+
+}  // namespace action
+}  // namespace multio
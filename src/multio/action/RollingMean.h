@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef multio_server_actions_RollingMean_H
+#define multio_server_actions_RollingMean_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace multio {
+namespace action {
+
+class Average;
+
+// Mean over the last `window` completed periods. Each period's partial sums are kept in a ring
+// buffer so that the running total is updated by adding the newest and dropping the oldest slot.
+class RollingMean {
+public:
+    RollingMean(long window, long sz);
+
+    void push(const Average& partial, long startStep, long endStep);
+
+    bool full() const;
+
+    const std::vector<double>& compute();
+
+    std::string stepRange() const;
+
+    long window() const;
+
+private:
+    void print(std::ostream& os) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const RollingMean& a) {
+        a.print(os);
+        return os;
+    }
+
+    const long window_;
+
+    std::vector<std::vector<double>> sums_;
+    std::vector<long> counts_;
+    std::vector<long> startSteps_;
+
+    std::vector<double> total_;
+    long totalCount_ = 0;
+
+    std::vector<double> values_;
+
+    size_t next_ = 0;
+    size_t filled_ = 0;
+    long endStep_ = 0;
+};
+
+}  // namespace action
+}  // namespace multio
+
+#endif // multio_server_actions_RollingMean_H
@@ -13,6 +13,8 @@
 #include <algorithm>
 
 #include "eckit/config/Configuration.h"
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/exception/Exceptions.h"
 
 #include "multio/LibMultio.h"
 #include "multio/util/ScopedTimer.h"
@@ -21,14 +23,47 @@ namespace multio {
 namespace action {
 
 namespace {
-std::vector<std::string> fetch_items(const std::string& match, const eckit::Configuration& config) {
-    return (match == "category") ? config.getStringVector("categories")
-                                 : config.getStringVector("fields");
+std::unordered_set<std::string> fetch_items(const std::string& match,
+                                            const eckit::Configuration& config) {
+    const auto& items = (match == "category") ? config.getStringVector("categories")
+                                               : config.getStringVector("fields");
+    return std::unordered_set<std::string>{begin(items), end(items)};
 }
 }  // namespace
 
+std::vector<Select::Condition> Select::fetchConditions(const eckit::Configuration& config) {
+    std::vector<Condition> conditions;
+    if (not config.has("where")) {
+        return conditions;
+    }
+
+    for (const auto& cfg : config.getSubConfigurations("where")) {
+        Condition cond{cfg.getString("key"), {}, cfg.has("range"), 0, 0};
+        if (cond.isRange) {
+            auto range = cfg.getLongVector("range");
+            if (range.size() != 2 || range[0] > range[1]) {
+                throw eckit::UserError("Select condition on " + cond.key +
+                                       " must define a range as [lower, upper]");
+            }
+            cond.lower = range[0];
+            cond.upper = range[1];
+        }
+        else {
+            const auto& values = cfg.getStringVector("values");
+            cond.values.insert(begin(values), end(values));
+        }
+        conditions.push_back(std::move(cond));
+    }
+
+    return conditions;
+}
+
 Select::Select(const eckit::Configuration& config) :
-    Action{config}, match_{config.getString("match")}, items_{fetch_items(match_, config)} {}
+    Action{config},
+    match_{config.getString("match")},
+    matchCategory_{match_ == "category"},
+    items_{fetch_items(match_, config)},
+    conditions_{fetchConditions(config)} {}
 
 void Select::execute(Message msg) const {
     util::ScopedTimer timer{timing_};
@@ -38,30 +73,69 @@ void Select::execute(Message msg) const {
     }
 }
 
+bool Select::acceptsField(const std::string& name, const std::string& category) const {
+    return items_.find(matchCategory_ ? category : name) != end(items_);
+}
+
 bool Select::isMatched(const Message& msg) const {
     return (msg.tag() != Message::Tag::Field) || matchPlan(msg);
 }
 
 bool Select::matchPlan(const Message& msg) const {
-    auto item = (match_ == "category") ? msg.category() : msg.name();
+    const auto& item = matchCategory_ ? msg.category() : msg.name();
 
     LOG_DEBUG_LIB(LibMultio) << " *** Item " << item << " is being matched... ";
 
-    bool ret = find(begin(items_), end(items_), item) != end(items_);
+    bool ret = (items_.find(item) != end(items_)) && matchConditions(msg);
 
     LOG_DEBUG_LIB(LibMultio) << (ret ? "found" : "not found") << std::endl;
 
     return ret;
 }
 
+bool Select::matchConditions(const Message& msg) const {
+    const auto& md = msg.metadata();
+    for (const auto& cond : conditions_) {
+        if (not md.has(cond.key)) {
+            return false;
+        }
+
+        if (cond.isRange) {
+            auto val = md.getLong(cond.key);
+            if (val < cond.lower || cond.upper < val) {
+                return false;
+            }
+        }
+        else if (cond.values.find(md.getString(cond.key)) == end(cond.values)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void Select::print(std::ostream& os) const {
-    os << "Select(categories=";
+    os << "Select(" << (matchCategory_ ? "categories" : "fields") << "=";
     bool first = true;
     for(const auto& cat : items_) {
         os << (first ? "" : ", ");
         os << cat;
         first = false;
     }
+    for (const auto& cond : conditions_) {
+        os << ", " << cond.key;
+        if (cond.isRange) {
+            os << " in [" << cond.lower << ", " << cond.upper << "]";
+        }
+        else {
+            os << " in {";
+            first = true;
+            for (const auto& val : cond.values) {
+                os << (first ? "" : ", ") << val;
+                first = false;
+            }
+            os << "}";
+        }
+    }
     os << ")";
 }
 
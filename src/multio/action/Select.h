@@ -18,6 +18,7 @@
 #define multio_server_actions_Select_H
 
 #include <iosfwd>
+#include <unordered_set>
 #include <vector>
 
 #include "multio/action/Action.h"
@@ -35,6 +36,8 @@ public:
 
     void execute(Message msg) const override;
 
+    bool acceptsField(const std::string& name, const std::string& category) const override;
+
 private:
     void print(std::ostream &os) const override;
 
@@ -42,9 +45,23 @@ private:
 
     bool matchPlan(const Message& msg) const;
 
-    std::string match_;
-    std::vector<std::string> items_;
+    bool matchConditions(const Message& msg) const;
+
+    // Additional predicate on a metadata key, checked only once the name or category matched
+    struct Condition {
+        std::string key;
+        std::unordered_set<std::string> values;
+        bool isRange;
+        long lower;
+        long upper;
+    };
+
+    static std::vector<Condition> fetchConditions(const eckit::Configuration& config);
 
+    const std::string match_;
+    const bool matchCategory_;
+    const std::unordered_set<std::string> items_;
+    const std::vector<Condition> conditions_;
 };
 
 }  // namespace action
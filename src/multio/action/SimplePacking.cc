@@ -0,0 +1,234 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "SimplePacking.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "eckit/exception/Exceptions.h"
+
+namespace multio {
+namespace action {
+
+namespace {
+
+// Same as ecCodes' codes_power: repeated multiplication, so that the decimal factors round alike
+double power(long s, long n) {
+    double divisor = 1.0;
+    if (s == 0) {
+        return 1.0;
+    }
+    if (s == 1) {
+        return n;
+    }
+    while (s < 0) {
+        divisor /= n;
+        ++s;
+    }
+    while (s > 0) {
+        divisor *= n;
+        --s;
+    }
+    return divisor;
+}
+
+// Largest IEEE single precision value not greater than x; subnormals are not used, as in ecCodes
+bool nearestSmallerFloat(double x, double& result) {
+    if (x > FLT_MAX || x < -FLT_MAX) {
+        return false;
+    }
+    if (x == 0.0) {
+        result = 0.0;
+        return true;
+    }
+    if (std::fabs(x) < FLT_MIN) {
+        result = (x > 0.0) ? 0.0 : -FLT_MIN;
+        return true;
+    }
+
+    auto f = static_cast<float>(x);
+    if (static_cast<double>(f) > x) {
+        f = std::nextafter(f, -FLT_MAX);
+    }
+    result = f;
+    return true;
+}
+
+// Same as ecCodes' grib_get_binary_scale_fact
+bool computeBinaryScaleFactor(double max, double min, long bitsPerValue, long& scale) {
+    const long last = 127;
+    const double dmaxint = power(bitsPerValue, 2) - 1;
+    const auto maxint = static_cast<unsigned long>(dmaxint);
+
+    double range = max - min;
+    double zs = 1;
+    scale = 0;
+
+    while ((range * zs) <= dmaxint) {
+        scale--;
+        zs *= 2;
+    }
+    while ((range * zs) > dmaxint) {
+        scale++;
+        zs /= 2;
+    }
+    while (static_cast<unsigned long>(range * zs + 0.5) <= maxint) {
+        scale--;
+        zs *= 2;
+    }
+    while (static_cast<unsigned long>(range * zs + 0.5) > maxint) {
+        scale++;
+        zs /= 2;
+    }
+
+    return -last <= scale && scale <= last;
+}
+
+void encodeSigned16(long value, unsigned char* p) {
+    auto magnitude = static_cast<unsigned long>(std::labs(value));
+    p[0] = static_cast<unsigned char>(((value < 0) ? 0x80 : 0x00) | ((magnitude >> 8) & 0x7f));
+    p[1] = static_cast<unsigned char>(magnitude & 0xff);
+}
+
+// Packs values that take a whole number of bytes. Each value is stored at a fixed offset and
+// converted through a signed integer wide enough for it, so that compilers can vectorise the loop
+template <size_t Bytes>
+void packBytes(const double* values, size_t count, double d, double reference, double divisor,
+               unsigned char* out) {
+    using Integer = typename std::conditional<(Bytes < 4), int32_t, int64_t>::type;
+    for (size_t i = 0; i < count; ++i) {
+        auto value = static_cast<Integer>((((values[i] * d) - reference) * divisor) + 0.5);
+        for (size_t b = 0; b < Bytes; ++b) {
+            out[Bytes * i + b] = static_cast<unsigned char>(value >> (8 * (Bytes - 1 - b)));
+        }
+    }
+}
+
+}  // namespace
+
+SimplePacking::SimplePacking(long bitsPerValue) : bitsPerValue_{bitsPerValue} {
+    ASSERT(0 < bitsPerValue_ && bitsPerValue_ <= 32);
+}
+
+bool SimplePacking::computeParameters(const double* values, size_t count) {
+    if (count == 0) {
+        return false;
+    }
+
+    double min = values[0];
+    double max = values[0];
+    for (size_t i = 1; i < count; ++i) {
+        min = std::min(min, values[i]);
+        max = std::max(max, values[i]);
+    }
+
+    if (not(std::isfinite(min) && std::isfinite(max)) || max == min) {
+        return false;
+    }
+
+    const long last = 127;
+    const double f = power(bitsPerValue_, 2) - 1;
+    const double minrange = power(-last, 2) * f;
+    const double maxrange = power(last, 2) * f;
+
+    const double unscaledMin = min;
+    const double unscaledMax = max;
+
+    double decimal = 1;
+    double range = max - min;
+
+    decimalScaleFactor_ = 0;
+    while (range < minrange) {
+        decimalScaleFactor_ += 1;
+        decimal *= 10;
+        min = unscaledMin * decimal;
+        max = unscaledMax * decimal;
+        range = max - min;
+    }
+    while (range > maxrange) {
+        decimalScaleFactor_ -= 1;
+        decimal /= 10;
+        min = unscaledMin * decimal;
+        max = unscaledMax * decimal;
+        range = max - min;
+    }
+
+    // As in ecCodes, the binary scale factor covers the range from the reference value, which may
+    // lie below the minimum, so that the maximum still packs into bitsPerValue bits
+    return nearestSmallerFloat(min, referenceValue_) &&
+           computeBinaryScaleFactor(max, referenceValue_, bitsPerValue_, binaryScaleFactor_);
+}
+
+size_t SimplePacking::packedLength(size_t count) const {
+    return (bitsPerValue_ * count + 7) / 8;
+}
+
+void SimplePacking::pack(const double* values, size_t count, unsigned char* out) const {
+    const double d = power(decimalScaleFactor_, 10);
+    const double divisor = power(-binaryScaleFactor_, 2);
+    const double reference = referenceValue_;
+
+    switch (bitsPerValue_) {
+        case 8:
+            packBytes<1>(values, count, d, reference, divisor, out);
+            return;
+        case 16:
+            packBytes<2>(values, count, d, reference, divisor, out);
+            return;
+        case 24:
+            packBytes<3>(values, count, d, reference, divisor, out);
+            return;
+        case 32:
+            packBytes<4>(values, count, d, reference, divisor, out);
+            return;
+        default:
+            break;
+    }
+
+    const uint64_t mask = (uint64_t{1} << bitsPerValue_) - 1;
+    uint64_t acc = 0;
+    long bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        auto value = static_cast<unsigned long>((((values[i] * d) - reference) * divisor) + 0.5);
+        acc = (acc << bitsPerValue_) | (value & mask);
+        bits += bitsPerValue_;
+        while (bits >= 8) {
+            bits -= 8;
+            *out++ = static_cast<unsigned char>(acc >> bits);
+        }
+    }
+    if (bits > 0) {
+        *out = static_cast<unsigned char>(acc << (8 - bits));
+    }
+}
+
+void SimplePacking::encodeSection5(unsigned char* section5) const {
+    auto reference = static_cast<float>(referenceValue_);
+    uint32_t bits;
+    std::memcpy(&bits, &reference, sizeof(bits));
+
+    section5[11] = static_cast<unsigned char>(bits >> 24);
+    section5[12] = static_cast<unsigned char>(bits >> 16);
+    section5[13] = static_cast<unsigned char>(bits >> 8);
+    section5[14] = static_cast<unsigned char>(bits);
+
+    encodeSigned16(binaryScaleFactor_, section5 + 15);
+    encodeSigned16(decimalScaleFactor_, section5 + 17);
+
+    section5[19] = static_cast<unsigned char>(bitsPerValue_);
+}
+
+}  // namespace action
+}  // namespace multio
@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_server_actions_SimplePacking_H
+#define multio_server_actions_SimplePacking_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace multio {
+namespace action {
+
+// Native implementation of GRIB2 simple packing (data representation template 5.0) with a fixed
+// number of bits per value. It follows the ecCodes algorithm step by step, so that section 5 and
+// section 7 are bit-identical to what codes_set_double_array produces.
+
+class SimplePacking {
+public:
+    explicit SimplePacking(long bitsPerValue);
+
+    // Returns false if the values cannot be packed natively, e.g. constant fields, which ecCodes
+    // encodes without a data section
+    bool computeParameters(const double* values, size_t count);
+
+    size_t packedLength(size_t count) const;
+
+    // Writes the packed values; `out` must hold at least packedLength(count) bytes
+    void pack(const double* values, size_t count, unsigned char* out) const;
+
+    // Writes octets 12-20 of section 5: reference value, scale factors and bits per value
+    void encodeSection5(unsigned char* section5) const;
+
+    double referenceValue() const { return referenceValue_; }
+    long binaryScaleFactor() const { return binaryScaleFactor_; }
+    long decimalScaleFactor() const { return decimalScaleFactor_; }
+    long bitsPerValue() const { return bitsPerValue_; }
+
+private:
+    const long bitsPerValue_;
+
+    double referenceValue_ = 0.0;
+    long binaryScaleFactor_ = 0;
+    long decimalScaleFactor_ = 0;
+};
+
+}  // namespace action
+}  // namespace multio
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "SingleFieldSink.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "eckit/config/Configuration.h"
@@ -24,7 +25,10 @@ namespace action {
 
 SingleFieldSink::SingleFieldSink(const eckit::Configuration& config) :
     Action{config},
-    rootPath_{config.getString("root_path", "")} {}
+    rootPath_{config.getString("root_path", "")},
+    pathTemplate_{compilePathTemplate(
+        config.getString("path-template", "{level}::{param}::{step}"))},
+    maxOpenFiles_{std::max<size_t>(1, config.getUnsigned("max-open-files", 256))} {}
 
 void SingleFieldSink::execute(Message msg) const {
     switch (msg.tag()) {
@@ -45,35 +49,99 @@ void SingleFieldSink::execute(Message msg) const {
 }
 
 void SingleFieldSink::write(Message msg) const {
-    std::ostringstream oss;
-    oss << rootPath_ << msg.metadata().getUnsigned("level")
-        << "::" << msg.metadata().getString("param")
-        << "::" << msg.metadata().getUnsigned("step");
-    eckit::LocalConfiguration config;
+    const auto& outputPath = path(msg.metadata());
 
-    LOG_DEBUG_LIB(LibMultio) << "Writing output path: " << oss.str() << std::endl;
-    config.set("path", oss.str());
-    dataSink_.reset(DataSinkFactory::instance().build("file", config));
+    LOG_DEBUG_LIB(LibMultio) << "Writing output path: " << outputPath << std::endl;
 
     eckit::message::Message blob = to_eckit_message(msg);
 
-    dataSink_->write(blob);
+    dataSink(outputPath).write(blob);
 }
 
 void SingleFieldSink::flush() const {
     eckit::Log::debug<LibMultio>()
-        << "*** Executing single-field flush for data sink... " << std::endl;
-    if (dataSink_) {
-        dataSink_->flush();
+        << "*** Executing single-field flush for " << dataSinks_.size() << " data sinks... "
+        << std::endl;
+
+    // The fields of a step are complete, so their files are closed
+    for (auto& sink : dataSinks_) {
+        sink.second->flush();
     }
+    dataSinks_.clear();
+    sinkIndex_.clear();
+    written_.clear();
 }
 
-void SingleFieldSink::print(std::ostream& os) const {
-    if (dataSink_) {
-        os << "Sink(DataSink=" << *dataSink_ << ")";
-    } else {
-        os << "Sink(DataSink=NULL)";
+const std::string& SingleFieldSink::path(const message::Metadata& metadata) const {
+    path_ = rootPath_;
+    for (const auto& segment : pathTemplate_) {
+        if (not segment.isKey) {
+            path_ += segment.text;
+        }
+        else if (metadata.isString(segment.text)) {
+            path_ += metadata.getString(segment.text);
+        }
+        else {
+            path_ += std::to_string(metadata.getLong(segment.text));
+        }
+    }
+    return path_;
+}
+
+DataSink& SingleFieldSink::dataSink(const std::string& path) const {
+    auto it = sinkIndex_.find(path);
+    if (it != end(sinkIndex_)) {
+        dataSinks_.splice(begin(dataSinks_), dataSinks_, it->second);
+        return *dataSinks_.front().second;
+    }
+
+    if (dataSinks_.size() >= maxOpenFiles_) {
+        dataSinks_.back().second->flush();
+        sinkIndex_.erase(dataSinks_.back().first);
+        dataSinks_.pop_back();
+    }
+
+    eckit::LocalConfiguration config;
+    config.set("path", path);
+    config.set("append", not written_.insert(path).second);
+
+    dataSinks_.emplace_front(
+        path, std::unique_ptr<DataSink>{DataSinkFactory::instance().build("file", config)});
+    sinkIndex_[path] = begin(dataSinks_);
+
+    return *dataSinks_.front().second;
+}
+
+std::vector<SingleFieldSink::PathSegment> SingleFieldSink::compilePathTemplate(
+    const std::string& pathTemplate) {
+    std::vector<SingleFieldSink::PathSegment> segments;
+
+    std::string::size_type pos = 0;
+    while (pos < pathTemplate.size()) {
+        auto open = pathTemplate.find('{', pos);
+        if (open == std::string::npos) {
+            segments.push_back({pathTemplate.substr(pos), false});
+            break;
+        }
+
+        auto close = pathTemplate.find('}', open);
+        if (close == std::string::npos || close == open + 1) {
+            throw eckit::UserError("Malformed path template: " + pathTemplate, Here());
+        }
+
+        if (open > pos) {
+            segments.push_back({pathTemplate.substr(pos, open - pos), false});
+        }
+        segments.push_back({pathTemplate.substr(open + 1, close - open - 1), true});
+
+        pos = close + 1;
     }
+
+    return segments;
+}
+
+void SingleFieldSink::print(std::ostream& os) const {
+    os << "SingleFieldSink(root_path=" << rootPath_ << ", open files=" << dataSinks_.size() << ")";
 }
 
 static ActionBuilder<SingleFieldSink> SinkBuilder("SingleFieldSink");
@@ -18,6 +18,12 @@
 #define multio_server_actions_SingleFieldSink_H
 
 #include <iosfwd>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "multio/action/Action.h"
 
@@ -46,9 +52,31 @@ private:
 
     void flush() const;
 
+    const std::string& path(const message::Metadata& metadata) const;
+    DataSink& dataSink(const std::string& path) const;
+
+    // Output path template, split once into literal text and metadata keys
+    struct PathSegment {
+        std::string text;
+        bool isKey;
+    };
+
+    static std::vector<PathSegment> compilePathTemplate(const std::string& pathTemplate);
+
     std::string rootPath_;
+    std::vector<PathSegment> pathTemplate_;
+
+    mutable std::string path_;
+
+    // Open file sinks, most recently used first
+    using SinkList = std::list<std::pair<std::string, std::unique_ptr<DataSink>>>;
+
+    mutable SinkList dataSinks_;
+    mutable std::unordered_map<std::string, SinkList::iterator> sinkIndex_;
+    const size_t maxOpenFiles_;
 
-    mutable std::unique_ptr<DataSink> dataSink_ = nullptr;
+    // Paths written since the last flush, so that files closed early are reopened for appending
+    mutable std::unordered_set<std::string> written_;
 };
 
 }  // namespace action
@@ -11,11 +11,14 @@
 #include "Statistics.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "eckit/config/Configuration.h"
 #include "eckit/exception/Exceptions.h"
 
 #include "multio/LibMultio.h"
+#include "multio/action/Operation.h"
+#include "multio/action/RollingMean.h"
 #include "multio/action/TemporalStatistics.h"
 #include "multio/util/ScopedTimer.h"
 
@@ -42,13 +45,72 @@ long set_frequency(const std::string& output_freq) {
     return std::stol(freq);
 }
 
+// Only used for ordering -- a month is never split into anything coarser than a day
+long approximate_hours(const Statistics::OutputFrequency& freq) {
+    const std::map<std::string, long> unit_to_hours{{"hour", 1}, {"day", 24}, {"month", 24 * 31}};
+    return unit_to_hours.at(freq.timeUnit) * freq.timeSpan;
+}
+
+// Coarser periods are derived from the partial results of finer ones, so every finer period
+// must end on the boundary of the next coarser one
+bool nests_into(const Statistics::OutputFrequency& finer,
+                const Statistics::OutputFrequency& coarser) {
+    if (finer.timeUnit == coarser.timeUnit) {
+        return coarser.timeSpan % finer.timeSpan == 0;
+    }
+    if (finer.timeUnit == "hour") {
+        return (coarser.timeUnit == "day" ? 24 * coarser.timeSpan : 24) % finer.timeSpan == 0;
+    }
+    return finer.timeUnit == "day" && coarser.timeUnit == "month" && finer.timeSpan == 1;
+}
+
+std::vector<Statistics::OutputFrequency> set_frequencies(const eckit::Configuration& config) {
+    auto freqs = config.has("output_frequencies")
+                     ? config.getStringVector("output_frequencies")
+                     : std::vector<std::string>{config.getString("output_frequency")};
+
+    if (freqs.empty()) {
+        throw eckit::UserError{"Statistics must define at least one output frequency"};
+    }
+
+    std::vector<Statistics::OutputFrequency> ret;
+    for (const auto& freq : freqs) {
+        ret.push_back({set_unit(freq), set_frequency(freq)});
+    }
+
+    std::sort(begin(ret), end(ret),
+              [](const Statistics::OutputFrequency& lhs, const Statistics::OutputFrequency& rhs) {
+                  return approximate_hours(lhs) < approximate_hours(rhs);
+              });
+
+    for (auto it = begin(ret) + 1; it < end(ret); ++it) {
+        if (not nests_into(*(it - 1), *it)) {
+            throw eckit::UserError{"Output frequency " + std::to_string((it - 1)->timeSpan) + " " +
+                                   (it - 1)->timeUnit + " does not nest into " +
+                                   std::to_string(it->timeSpan) + " " + it->timeUnit};
+        }
+    }
+
+    return ret;
+}
+
+long set_rolling_window(const eckit::Configuration& config,
+                        const std::vector<std::string>& operations) {
+    auto window = config.getLong("rolling_window", 0);
+    if (window > 0 &&
+        std::find(begin(operations), end(operations), "average") == end(operations)) {
+        throw eckit::UserError{"Rolling-window means require the 'average' operation"};
+    }
+    return window;
+}
+
 }  // namespace
 
 Statistics::Statistics(const eckit::Configuration& config) :
     Action{config},
-    timeUnit_{set_unit(config.getString("output_frequency"))},
-    timeSpan_{set_frequency(config.getString("output_frequency"))},
-    operations_{config.getStringVector("operations")} {}
+    frequencies_{set_frequencies(config)},
+    operations_{config.getStringVector("operations")},
+    rollingWindow_{set_rolling_window(config, operations_)} {}
 
 void Statistics::execute(message::Message msg) const {
     util::ScopedTimer timer{timing_};
@@ -57,23 +119,61 @@ void Statistics::execute(message::Message msg) const {
                              << std::endl;
 
     // Create a unique key for the fieldStats_ map
-    std::ostringstream os;
-    os << msg.metadata().getString("category") << msg.metadata().getString("nemoParam")
-       << msg.metadata().getString("param");
+    const auto& md = msg.metadata();
+    auto key = md.getString("category") + md.getString("nemoParam") + md.getString("param");
 
-    if (fieldStats_.find(os.str()) == end(fieldStats_)) {
-        fieldStats_[os.str()] = TemporalStatistics::build(timeUnit_, timeSpan_, operations_, msg);
+    auto it = fieldStats_.find(key);
+    if (it == end(fieldStats_)) {
+        it = fieldStats_.emplace(key, makeFieldStatistics(msg)).first;
     }
 
-    if(fieldStats_.at(os.str())->process(msg)) {
+    auto& periods = it->second.periods;
+
+    if (periods.front()->process(msg)) {
         return;
     }
 
+    // Partial results must be handed on to the coarser periods before compute() finalises them
+    auto completed = 1u;
+    while (completed != periods.size() &&
+           not periods[completed]->process(*periods[completed - 1], msg)) {
+        ++completed;
+    }
+
+    if (it->second.rolling) {
+        const auto& partial = dynamic_cast<const Average&>(periods.front()->operation("average"));
+        it->second.rolling->push(partial, periods.front()->startStep(),
+                                 periods.front()->currentStep());
+        if (it->second.rolling->full()) {
+            emit(*it->second.rolling, msg);
+        }
+    }
+
+    for (auto ii = 0u; ii != completed; ++ii) {
+        emit(*periods[ii], frequencies_[ii], msg);
+    }
+}
+
+Statistics::FieldStatistics Statistics::makeFieldStatistics(const message::Message& msg) const {
+    FieldStatistics stats;
+    for (const auto& freq : frequencies_) {
+        stats.periods.push_back(
+            TemporalStatistics::build(freq.timeUnit, freq.timeSpan, operations_, msg));
+    }
+    if (rollingWindow_ > 0) {
+        stats.rolling.reset(
+            new RollingMean{rollingWindow_, static_cast<long>(msg.size() / sizeof(double))});
+    }
+    return stats;
+}
+
+void Statistics::emit(TemporalStatistics& stats, const OutputFrequency& freq,
+                      const message::Message& msg) const {
     auto md = msg.metadata();
-    md.set("timeUnit", timeUnit_);
-    md.set("timeSpan", timeSpan_);
-    md.set("stepRange", fieldStats_.at(os.str())->stepRange(md.getLong("step")));
-    for (auto&& stat : fieldStats_.at(os.str())->compute(msg)) {
+    md.set("timeUnit", freq.timeUnit);
+    md.set("timeSpan", freq.timeSpan);
+    md.set("stepRange", stats.stepRange());
+    for (auto&& stat : stats.compute(msg)) {
         md.set("operation", stat.first);
         message::Message newMsg{
             message::Message::Header{message::Message::Tag::Statistics, msg.source(),
@@ -83,13 +183,43 @@ void Statistics::execute(message::Message msg) const {
         executeNext(newMsg);
     }
 
-    fieldStats_.at(os.str())->reset(msg);
+    stats.reset(msg);
+}
+
+void Statistics::emit(RollingMean& rolling, const message::Message& msg) const {
+    const auto& base = frequencies_.front();
+
+    auto md = msg.metadata();
+    md.set("timeUnit", base.timeUnit);
+    md.set("timeSpan", base.timeSpan * rolling.window());
+    md.set("rollingWindow", rolling.window());
+    md.set("stepRange", rolling.stepRange());
+    md.set("operation", "average");
+
+    eckit::Buffer buf{msg.size()};
+    std::memcpy(buf, rolling.compute().data(), msg.size());
+
+    message::Message newMsg{
+        message::Message::Header{message::Message::Tag::Statistics, msg.source(),
+                                 msg.destination(), message::Metadata{md}},
+        std::move(buf)};
+
+    executeNext(newMsg);
 }
 
 void Statistics::print(std::ostream& os) const {
-    os << "Statistics(output frequency = " << timeSpan_ << ", unit = " << timeUnit_
-       << ", operations = ";
+    os << "Statistics(output frequencies = ";
     bool first = true;
+    for (const auto& freq : frequencies_) {
+        os << (first ? "" : ", ");
+        os << freq.timeSpan << " " << freq.timeUnit;
+        first = false;
+    }
+    if (rollingWindow_ > 0) {
+        os << ", rolling window = " << rollingWindow_;
+    }
+    os << ", operations = ";
+    first = true;
     for (const auto& ops : operations_) {
         os << (first ? "" : ", ");
         os << ops;
@@ -26,6 +26,7 @@ namespace eckit { class Configuration; }
 namespace multio {
 namespace action {
 
+class RollingMean;
 class TemporalStatistics;
 
 class Statistics : public Action {
@@ -34,15 +35,34 @@ public:
 
     void execute(message::Message msg) const override;
 
+    struct OutputFrequency {
+        std::string timeUnit;
+        long timeSpan;
+    };
+
 private:
+    // All output frequencies of a field share a single update of the raw data: only the finest
+    // period sees the field values, the coarser ones are built from its partial results
+    struct FieldStatistics {
+        std::vector<std::unique_ptr<TemporalStatistics>> periods;  // Finest first
+        std::unique_ptr<RollingMean> rolling;
+    };
+
     void print(std::ostream &os) const override;
 
-    const std::string timeUnit_;
-    const long timeSpan_;
+    FieldStatistics makeFieldStatistics(const message::Message& msg) const;
+
+    void emit(TemporalStatistics& stats, const OutputFrequency& freq,
+              const message::Message& msg) const;
+    void emit(RollingMean& rolling, const message::Message& msg) const;
+
+    const std::vector<OutputFrequency> frequencies_;
 
     const std::vector<std::string> operations_;
 
-    mutable std::map<std::string, std::unique_ptr<TemporalStatistics>> fieldStats_;
+    const long rollingWindow_;
+
+    mutable std::map<std::string, FieldStatistics> fieldStats_;
 };
 
 }  // namespace action
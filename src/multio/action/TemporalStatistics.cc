@@ -1,8 +1,10 @@
 
 #include "TemporalStatistics.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <sstream>
 
 #include "eckit/exception/Exceptions.h"
 #include "multio/LibMultio.h"
@@ -20,11 +22,10 @@ std::vector<std::unique_ptr<Operation>> reset_statistics(const std::vector<std::
     return stats;
 }
 
-eckit::DateTime currentDateTime(const message::Message& msg) {
-    eckit::Date startDate{eckit::Date{msg.metadata().getLong("date")}};
-    eckit::DateTime startDateTime{startDate, eckit::Time{0}};
-    return startDateTime + static_cast<eckit::Second>(msg.metadata().getLong("step") *
-                                                      msg.metadata().getLong("timeStep"));
+[[noreturn]] void outsidePeriod(long seconds, const DateTimePeriod& period) {
+    std::ostringstream os;
+    os << seconds << "s is outside of current period " << period;
+    throw eckit::SeriousBug(os.str(), Here());
 }
 }  // namespace
 
@@ -58,6 +59,28 @@ bool TemporalStatistics::process(message::Message& msg) {
     return process_next(msg);
 }
 
+bool TemporalStatistics::process(const TemporalStatistics& finer, const message::Message& msg) {
+    ASSERT(opNames_ == finer.opNames_);
+
+    LOG_DEBUG_LIB(LibMultio) << *this << " <-- " << finer << std::endl;
+
+    // The finer period has just processed the same message
+    step_ = finer.step_;
+    timeStep_ = finer.timeStep_;
+    seconds_ = finer.seconds_;
+
+    if (not current_.isWithin(seconds_)) {
+        outsidePeriod(seconds_, current_);
+    }
+
+    // Partial results of the finer period are combined rather than recomputed from the field
+    for (size_t ii = 0; ii != statistics_.size(); ++ii) {
+        statistics_[ii]->merge(*finer.statistics_[ii]);
+    }
+
+    return current_.isWithin(seconds_ + timeStep_);
+}
+
 void TemporalStatistics::updateStatistics(const message::Message& msg) {
     auto data_ptr = static_cast<const double*>(msg.payload().data());
     for(auto const& stat : statistics_) {
@@ -70,23 +93,24 @@ bool TemporalStatistics::process_next(message::Message& msg) {
 
     LOG_DEBUG_LIB(LibMultio) << *this << std::endl;
 
-    auto dateTime = currentDateTime(msg);
+    const auto& md = msg.metadata();
+    step_ = md.getLong("step");
+    timeStep_ = md.getLong("timeStep");
+    seconds_ = step_ * timeStep_;
 
-    std::ostringstream os;
-    os << dateTime << " is outside of current period " << current_ << std::endl;
     LOG_DEBUG_LIB(LibMultio) << " *** Current ";
-    ASSERT_MSG(current_.isWithin(dateTime), os.str());
+    if (not current_.isWithin(seconds_)) {
+        outsidePeriod(seconds_, current_);
+    }
 
     updateStatistics(msg);
 
-    dateTime = dateTime + static_cast<eckit::Second>(msg.metadata().getLong("timeStep"));
-
     LOG_DEBUG_LIB(LibMultio) << " *** Next    ";
-    return current_.isWithin(dateTime);
+    return current_.isWithin(seconds_ + timeStep_);
 }
 
-void TemporalStatistics::resetPeriod(const message::Message& msg) {
-    current_.reset(currentDateTime(msg));
+void TemporalStatistics::resetPeriod() {
+    current_.reset(seconds_);
 }
 
 std::map<std::string, eckit::Buffer> TemporalStatistics::compute(const message::Message& msg) {
@@ -100,16 +124,32 @@ std::map<std::string, eckit::Buffer> TemporalStatistics::compute(const message::
     return retStats;
 }
 
-std::string TemporalStatistics::stepRange(long step) {
-    auto ret = std::to_string(prevStep_) + "-" + std::to_string(step);
-    prevStep_ = step;
+std::string TemporalStatistics::stepRange() {
+    auto ret = std::to_string(prevStep_) + "-" + std::to_string(step_);
+    prevStep_ = step_;
     LOG_DEBUG_LIB(LibMultio) << " *** Setting step range: " << ret << std::endl;
     return ret;
 }
 
+const Operation& TemporalStatistics::operation(const std::string& opname) const {
+    auto it = std::find(begin(opNames_), end(opNames_), opname);
+    if (it == end(opNames_)) {
+        throw eckit::SeriousBug{"Operation " + opname + " is not computed by " + name_};
+    }
+    return *statistics_[std::distance(begin(opNames_), it)];
+}
+
+long TemporalStatistics::startStep() const {
+    return prevStep_;
+}
+
+long TemporalStatistics::currentStep() const {
+    return step_;
+}
+
 void TemporalStatistics::reset(const message::Message& msg) {
     statistics_ = reset_statistics(opNames_, msg.size() / sizeof(double));
-    resetPeriod(msg);
+    resetPeriod();
     LOG_DEBUG_LIB(LibMultio) << " ------ Resetting statistics for temporal type " << *this
                              << std::endl;
 }
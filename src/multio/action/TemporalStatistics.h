@@ -25,10 +25,15 @@ public:
     virtual ~TemporalStatistics() = default;
 
     bool process(message::Message& msg);
+    bool process(const TemporalStatistics& finer, const message::Message& msg);
     std::map<std::string, eckit::Buffer> compute(const message::Message& msg);
-    std::string stepRange(long step);
+    std::string stepRange();
+    long startStep() const;
+    long currentStep() const;
     void reset(const message::Message& msg);
 
+    const Operation& operation(const std::string& opname) const;
+
 protected:
 
     std::string name_;
@@ -39,7 +44,7 @@ protected:
 private:
     virtual bool process_next(message::Message& msg);
 
-    virtual void resetPeriod(const message::Message& msg);
+    virtual void resetPeriod();
 
     virtual void print(std::ostream& os) const = 0;
 
@@ -51,6 +56,11 @@ private:
     std::vector<std::string> opNames_;
     std::vector<std::unique_ptr<Operation>> statistics_;
     long prevStep_ = 0;
+
+    // Time metadata of the last message processed, decoded once per step
+    long step_ = 0;
+    long timeStep_ = 0;
+    long seconds_ = 0;
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -39,6 +39,10 @@ void Unstructured::to_global(const message::Message& local, message::Message& gl
     eckit::Log::debug<LibMultio>() << " *** Aggregation completed..." << std::endl;
 }
 
+std::vector<int32_t> Unstructured::global_indices() const {
+    return definition_;
+}
+
 //------------------------------------------------------------------------------------------------------------
 
 namespace {
@@ -98,6 +102,32 @@ void Structured::to_global(const message::Message& local, message::Message& glob
 
 }
 
+std::vector<int32_t> Structured::global_indices() const {
+    ASSERT(definition_.size() == 11);
+
+    auto ni_global = definition_[0];
+    auto ibegin = definition_[2];
+    auto ni = definition_[3];
+    auto jbegin = definition_[4];
+    auto nj = definition_[5];
+    auto data_ibegin = definition_[7];
+    auto data_ni = definition_[8];
+    auto data_jbegin = definition_[9];
+    auto data_nj = definition_[10];
+
+    // Same traversal as to_global
+    std::vector<int32_t> indices;
+    indices.reserve(static_cast<size_t>(data_ni) * static_cast<size_t>(data_nj));
+    for (auto j = data_jbegin; j != data_jbegin + data_nj; ++j) {
+        for (auto i = data_ibegin; i != data_ibegin + data_ni; ++i) {
+            indices.push_back(inRange(i, 0, ni) && inRange(j, 0, nj)
+                                  ? (jbegin + j) * ni_global + (ibegin + i)
+                                  : -1);
+        }
+    }
+    return indices;
+}
+
 //------------------------------------------------------------------------------------------------------------
 
 Spectral::Spectral(std::vector<int32_t>&& def) : Domain{std::move(def)} {}
@@ -110,5 +140,9 @@ void Spectral::to_global(const message::Message&, message::Message&) const {
     NOTIMP;
 }
 
+std::vector<int32_t> Spectral::global_indices() const {
+    NOTIMP;
+}
+
 }  // namespace domain
 }  // namespace multio
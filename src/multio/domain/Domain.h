@@ -24,6 +24,10 @@ public:
     virtual void to_local(const std::vector<double>& global, std::vector<double>& local) const = 0;
     virtual void to_global(const message::Message& local, message::Message& global) const = 0;
 
+    // Global index of every point of one level of local data, or -1 for points this domain does
+    // not own, such as halo points
+    virtual std::vector<int32_t> global_indices() const = 0;
+
 protected:
     std::vector<int32_t> definition_;  // Grid-point
 
@@ -36,6 +40,7 @@ public:
 private:
     void to_local(const std::vector<double>& global, std::vector<double>& local) const override;
     void to_global(const message::Message& local, message::Message& global) const override;
+    std::vector<int32_t> global_indices() const override;
 };
 
 class Structured final : public Domain {
@@ -45,6 +50,7 @@ public:
 private:
     void to_local(const std::vector<double>& global, std::vector<double>& local) const override;
     void to_global(const message::Message& local, message::Message& global) const override;
+    std::vector<int32_t> global_indices() const override;
 };
 
 class Spectral final : public Domain {
@@ -54,6 +60,7 @@ public:
 private:
     void to_local(const std::vector<double>& global, std::vector<double>& local) const override;
     void to_global(const message::Message& local, message::Message& global) const override;
+    std::vector<int32_t> global_indices() const override;
 };
 
 }  // namespace domain
@@ -14,7 +14,11 @@
 
 #include "multio/fdb5/FDB5Sink.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
 
 #include "multio/LibMultio.h"
 
@@ -32,24 +36,149 @@ eckit::LocalConfiguration fdb5_configuration(const eckit::Configuration& cfg) {
 }  // namespace
 
 FDB5Sink::FDB5Sink(const eckit::Configuration& config) :
-    DataSink(config), fdb_{fdb5_configuration(config)} {
+    DataSink(config),
+    fdb_{fdb5_configuration(config)},
+    async_{config.getBool("async", false)},
+    queueSize_{static_cast<size_t>(std::max(1L, config.getLong("queue-size", 64)))},
+    batchSize_{static_cast<size_t>(std::max(1L, config.getLong("batch-size", 16)))},
+    stats_{"FDB5Sink"} {
     LOG_DEBUG_LIB(LibMultio) << "Config = " << config << std::endl;
+
+    if (async_) {
+        archiver_ = std::thread{&FDB5Sink::archiveQueued, this};
+    }
+}
+
+FDB5Sink::~FDB5Sink() {
+    if (async_) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        notEmpty_.notify_one();
+        archiver_.join();
+
+        // A destructor cannot throw, so a failure after the last write or flush can only be logged
+        if (error_) {
+            eckit::Log::error() << "FDB5Sink: archive failure after the last write or flush"
+                                << std::endl;
+        }
+
+        eckit::Log::info() << " -- FDB5Sink maximum queue depth: " << maxQueueDepth_ << std::endl;
+    }
+
+    stats_.report(eckit::Log::info());
 }
 
 void FDB5Sink::write(eckit::message::Message msg) {
     LOG_DEBUG_LIB(LibMultio) << "FDB5Sink::write()" << std::endl;
 
-    fdb_.archive(msg);
+    if (not async_) {
+        archive(msg);
+        return;
+    }
+
+    // The caller may reuse the memory behind msg as soon as this returns
+    auto owned = owning_copy(msg);
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        rethrowError();
+        notFull_.wait(lock, [this]() { return queue_.size() < queueSize_; });
+        queue_.push_back(Request{std::move(owned), false});
+        maxQueueDepth_ = std::max(maxQueueDepth_, queue_.size());
+    }
+    notEmpty_.notify_one();
 }
 
 void FDB5Sink::flush() {
     LOG_DEBUG_LIB(LibMultio) << "FDB5Sink::flush()" << std::endl;
 
+    if (not async_) {
+        flushFDB();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    // The barrier is not subject to the queue bound, so a flush never waits for space
+    queue_.push_back(Request{eckit::message::Message{}, true});
+    const auto ticket = ++flushRequested_;
+    notEmpty_.notify_one();
+
+    flushed_.wait(lock, [this, ticket]() { return flushCompleted_ >= ticket; });
+
+    rethrowError();
+}
+
+void FDB5Sink::rethrowError() {
+    if (error_) {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void FDB5Sink::archive(const eckit::message::Message& msg) {
+    timer_.start();
+    fdb_.archive(msg);
+    timer_.stop();
+    stats_.logWrite(msg.length(), timer_);
+}
+
+void FDB5Sink::flushFDB() {
+    timer_.start();
     fdb_.flush();
+    timer_.stop();
+    stats_.logFlush(timer_);
+}
+
+void FDB5Sink::archiveQueued() {
+    std::vector<Request> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            notEmpty_.wait(lock, [this]() { return stop_ || not queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // Stopped, with everything archived
+            }
+
+            auto count = std::min(batchSize_, queue_.size());
+            std::move(begin(queue_), begin(queue_) + count, std::back_inserter(batch));
+            queue_.erase(begin(queue_), begin(queue_) + count);
+        }
+        notFull_.notify_all();
+
+        for (const auto& request : batch) {
+            try {
+                if (request.barrier) {
+                    flushFDB();
+                }
+                else {
+                    archive(request.msg);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+            }
+
+            if (request.barrier) {
+                {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    ++flushCompleted_;
+                }
+                flushed_.notify_all();
+            }
+        }
+        batch.clear();
+    }
 }
 
 void FDB5Sink::print(std::ostream& os) const {
-    os << "FDB5Sink()";
+    os << "FDB5Sink(async=" << (async_ ? "true" : "false") << ")";
 }
 
 static DataSinkBuilder<FDB5Sink> FDB5SinkBuilder("fdb5");
@@ -15,39 +15,87 @@
 #ifndef multio_fdb5_FDB5Sink_H
 #define multio_fdb5_FDB5Sink_H
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <iosfwd>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "eckit/io/Length.h"
+#include "eckit/log/Timer.h"
 #include "eckit/memory/NonCopyable.h"
 #include "eckit/types/Types.h"
 
 #include "fdb5/api/FDB.h"
 
 #include "multio/sink/DataSink.h"
+#include "multio/sink/IOStats.h"
 
 namespace multio {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Archives on a background thread if configured with `async: true`. Messages are copied and queued
+/// up to `queue-size`, and archived in batches of up to `batch-size`. A flush waits for everything
+/// queued before it. The first archive failure is rethrown by the next write or flush.
+
 class FDB5Sink : public multio::DataSink {
 public:
     explicit FDB5Sink(const eckit::Configuration& config);
 
+    ~FDB5Sink() override;
+
 private:
+    struct Request {
+        eckit::message::Message msg;
+        bool barrier;
+    };
+
     void write(eckit::message::Message msg) override;
 
     void flush() override;
 
     void print(std::ostream&) const override;
 
+    void archive(const eckit::message::Message& msg);
+    void flushFDB();
+
+    void archiveQueued();
+
+    // Call with mutex_ held
+    void rethrowError();
+
     friend std::ostream& operator<<(std::ostream& s, const FDB5Sink& p) {
         p.print(s);
         return s;
     }
 
     fdb5::FDB fdb_;
+
+    const bool async_;
+    const size_t queueSize_;
+    const size_t batchSize_;
+
+    std::deque<Request> queue_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::condition_variable flushed_;
+
+    size_t flushRequested_ = 0;
+    size_t flushCompleted_ = 0;
+    size_t maxQueueDepth_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    // Only touched by the thread that archives
+    IOStats stats_;
+    eckit::Timer timer_;
+
+    std::thread archiver_;
 };
 
 }  // namespace multio
@@ -74,11 +74,11 @@ Peer Message::destination() const {
     return header().destination();
 }
 
-std::string Message::name() const {
+const std::string& Message::name() const {
     return header().name();
 }
 
-std::string Message::category() const {
+const std::string& Message::category() const {
     return header().category();
 }
 
@@ -58,15 +58,17 @@ public:  // types
     public:
         Header(Tag tag, Peer src, Peer dst, std::string&& fieldId);
         Header(Tag tag, Peer src, Peer dst, Metadata&& md = message::Metadata{});
+        // For callers that have rendered the field id already. It must describe md.
+        Header(Tag tag, Peer src, Peer dst, Metadata&& md, std::string&& fieldId);
 
         Tag tag() const;
 
         Peer source() const;
         Peer destination() const;
 
-        std::string name() const;
+        const std::string& name() const;
 
-        std::string category() const;
+        const std::string& category() const;
 
         size_t domainCount() const;
 
@@ -88,6 +90,12 @@ public:  // types
 
         const Metadata metadata_;
         const std::string fieldId_; // Make that a hash?
+
+        // Decoded once, as every plan looks these up to select messages
+        const bool hasName_;
+        const bool hasCategory_;
+        const std::string name_;
+        const std::string category_;
     };
 
     class Content {
@@ -123,9 +131,9 @@ public:  // methods
     Peer source() const;
     Peer destination() const;
 
-    std::string name() const;
+    const std::string& name() const;
 
-    std::string category() const;
+    const std::string& category() const;
 
     size_t domainCount() const;
 
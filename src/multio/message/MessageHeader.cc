@@ -21,14 +21,33 @@ Message::Header::Header(Tag tag, Peer src, Peer dst, std::string&& fieldId) :
         source_{std::move(src)},
         destination_{std::move(dst)},
         metadata_{message::to_metadata(fieldId)},
-        fieldId_{std::move(fieldId)} {}
+        fieldId_{std::move(fieldId)},
+        hasName_{metadata_.has("name")},
+        hasCategory_{metadata_.has("category")},
+        name_{metadata_.getString("name", "")},
+        category_{metadata_.getString("category", "")} {}
 
 Message::Header::Header(Tag tag, Peer src, Peer dst, Metadata&& md) :
     tag_{tag},
     source_{std::move(src)},
     destination_{std::move(dst)},
     metadata_{std::move(md)},
-    fieldId_{message::to_string(metadata_)} {}
+    fieldId_{message::to_string(metadata_)},
+    hasName_{metadata_.has("name")},
+    hasCategory_{metadata_.has("category")},
+    name_{metadata_.getString("name", "")},
+    category_{metadata_.getString("category", "")} {}
+
+Message::Header::Header(Tag tag, Peer src, Peer dst, Metadata&& md, std::string&& fieldId) :
+    tag_{tag},
+    source_{std::move(src)},
+    destination_{std::move(dst)},
+    metadata_{std::move(md)},
+    fieldId_{std::move(fieldId)},
+    hasName_{metadata_.has("name")},
+    hasCategory_{metadata_.has("category")},
+    name_{metadata_.getString("name", "")},
+    category_{metadata_.getString("category", "")} {}
 
 Message::Tag Message::Header::tag() const {
     return tag_;
@@ -46,12 +65,19 @@ const Metadata& Message::Header::metadata() const {
     return metadata_;
 }
 
-std::string Message::Header::name() const {
-    return metadata_.getString("name");
+// Without the key, the metadata lookup throws, as it did before the values were cached
+const std::string& Message::Header::name() const {
+    if (not hasName_) {
+        metadata_.getString("name");
+    }
+    return name_;
 }
 
-std::string Message::Header::category() const {
-    return metadata_.getString("category");
+const std::string& Message::Header::category() const {
+    if (not hasCategory_) {
+        metadata_.getString("category");
+    }
+    return category_;
 }
 
 size_t Message::Header::domainCount() const {
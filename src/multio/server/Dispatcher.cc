@@ -35,6 +35,7 @@ Dispatcher::Dispatcher(const eckit::Configuration& config) {
     for (const auto& cfg : plans) {
         eckit::Log::debug<LibMultio>() << cfg << std::endl;
         plans_.emplace_back(new action::Plan(cfg));
+        allPlans_.push_back(plans_.back().get());
     }
 }
 
@@ -49,12 +50,38 @@ void Dispatcher::dispatch(eckit::Queue<message::Message>& queue) {
     util::ScopedTimer timer{timing_};
     message::Message msg;
     while (queue.pop(msg) >= 0) {
-        for (const auto& plan : plans_) {
+        for (const auto& plan : route(msg)) {
             plan->process(msg);
         }
     }
 }
 
+const Dispatcher::PlanList& Dispatcher::route(const message::Message& msg) {
+    if (msg.tag() != message::Message::Tag::Field) {
+        return allPlans_;
+    }
+
+    // Each field is resolved against the plans once, when it first arrives
+    auto& byName = routes_[msg.category()];
+    auto it = byName.find(msg.name());
+    if (it != end(byName)) {
+        return it->second;
+    }
+
+    PlanList plans;
+    for (const auto& plan : allPlans_) {
+        if (plan->acceptsField(msg.name(), msg.category())) {
+            plans.push_back(plan);
+        }
+    }
+
+    LOG_DEBUG_LIB(LibMultio) << "*** Routing field " << msg.category() << "/" << msg.name()
+                             << " to " << plans.size() << " of " << allPlans_.size() << " plans"
+                             << std::endl;
+
+    return byName.emplace(msg.name(), std::move(plans)).first->second;
+}
+
 }  // namespace server
 }  // namespace multio
 
@@ -18,6 +18,8 @@
 #define multio_server_Dispatcher_H
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "eckit/container/Queue.h"
 #include "eckit/log/Statistics.h"
@@ -46,8 +48,15 @@ public:
     void dispatch(eckit::Queue<message::Message>& queue);
 
 private:
+    using PlanList = std::vector<action::Plan*>;
+
+    const PlanList& route(const message::Message& msg);
 
     std::vector<std::unique_ptr<action::Plan>> plans_;
+
+    // Every plan sees non-field messages; fields only go to the plans whose root may accept them
+    PlanList allPlans_;
+    std::unordered_map<std::string, std::unordered_map<std::string, PlanList>> routes_;
     eckit::Timing timing_;
     eckit::Timer timer_;
 
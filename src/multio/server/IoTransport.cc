@@ -10,8 +10,12 @@
 
 #include "IoTransport.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <typeinfo>
+#include <vector>
 
 #include "eckit/config/YAMLConfiguration.h"
 
@@ -28,6 +32,7 @@ using multio::message::Metadata;
 using multio::print_buffer;
 using multio::server::Transport;
 using multio::server::TransportFactory;
+using multio::message::Peer;
 
 namespace {
 eckit::LocalConfiguration test_configuration(const std::string& type) {
@@ -42,6 +47,76 @@ eckit::LocalConfiguration test_configuration(const std::string& type) {
     return eckit::LocalConfiguration{testConfigs.getSubConfiguration(configs.at(type))};
 }
 
+/// Metadata of the messages being built, indexed by handle. Handles are looked up without a
+/// lock, so that threads filling in different messages do not contend; only creating and
+/// deleting a handle is serialised.
+class MessageBuilders {
+public:
+    ~MessageBuilders() {
+        for (auto& chunk : chunks_) {
+            delete chunk.load();
+        }
+    }
+
+    int create() {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        size_t handle;
+        if (free_.empty()) {
+            handle = next_++;
+            auto& chunk = chunks_.at(handle / chunkSize);
+            if (chunk.load(std::memory_order_relaxed) == nullptr) {
+                chunk.store(new Chunk, std::memory_order_release);
+            }
+        }
+        else {
+            handle = free_.back();
+            free_.pop_back();
+        }
+
+        if (live_.size() <= handle) {
+            live_.resize(handle + 1, false);
+        }
+        live_[handle] = true;
+
+        return static_cast<int>(handle);
+    }
+
+    // Releasing a handle twice would hand it out to two messages at once
+    void release(int handle) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            ASSERT(handle >= 0 && static_cast<size_t>(handle) < live_.size() && live_[handle]);
+            live_[handle] = false;
+        }
+
+        get(handle) = Metadata{};
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        free_.push_back(static_cast<size_t>(handle));
+    }
+
+    Metadata& get(int handle) {
+        ASSERT(handle >= 0 && static_cast<size_t>(handle) < chunkSize * chunkCount);
+        auto chunk = chunks_[handle / chunkSize].load(std::memory_order_acquire);
+        ASSERT(chunk != nullptr);
+        return (*chunk)[handle % chunkSize];
+    }
+
+private:
+    static constexpr size_t chunkSize = 1024;
+    static constexpr size_t chunkCount = 1024;
+
+    using Chunk = std::array<Metadata, chunkSize>;
+
+    std::array<std::atomic<Chunk*>, chunkCount> chunks_{};
+
+    std::mutex mutex_;
+    std::vector<size_t> free_;
+    std::vector<bool> live_;
+    size_t next_ = 0;
+};
+
 }  // namespace
 
 class IoTransport {
@@ -50,9 +125,13 @@ private:
     std::shared_ptr<Transport> transport_;
     Listener listener_;
     std::thread listenerThread_;
+    const Peer server_;
+
+    // Set by open_multio_connection_, before any worker threads start sending
+    Peer client_;
+    bool connected_ = false;
 
-    Metadata metadata_;
-    bool isOpen_ = false;
+    MessageBuilders builders_;
 
     // Default values -- how we set them will depend on the transport layer
     size_t clientCount_ = 1;
@@ -63,7 +142,8 @@ private:
         config_{test_configuration("thread")},
         transport_{TransportFactory::instance().build("thread", config_)},
         listener_{config_, *transport_},
-        listenerThread_{&Listener::listen, &listener_} {}
+        listenerThread_{&Listener::listen, &listener_},
+        server_{"thread", std::hash<std::thread::id>{}(listenerThread_.get_id())} {}
 
     ~IoTransport() {
         if (listenerThread_.joinable()) {
@@ -84,24 +164,33 @@ public:
         return *transport_;
     }
 
-    const std::thread& listenerThread() {
-        return listenerThread_;
+    const Peer& server() const {
+        return server_;
     }
 
-    Metadata& metadata() {
-        return metadata_;
+    // Messages from any thread are sent on behalf of the client that opened the connection
+    Peer client() {
+        return connected_ ? client_ : transport().localPeer();
     }
 
-    bool isOpen() const {
-        return isOpen_;
+    void connect() {
+        client_ = transport().localPeer();
+        connected_ = true;
     }
 
-    void open() {
-        isOpen_ = true;
+    // The message built by open_multio_message_ and friends, one per thread
+    Metadata& metadata() {
+        thread_local Metadata metadata;
+        return metadata;
+    }
+
+    bool& isOpen() {
+        thread_local bool isOpen = false;
+        return isOpen;
     }
 
-    void close() {
-        isOpen_ = false;
+    MessageBuilders& builders() {
+        return builders_;
     }
 
     void setDimensions(size_t nClient, size_t nServer, long glFieldSize) {
@@ -117,9 +206,36 @@ public:
     size_t globalSize() { return globalSize_; }
 };
 
-// C/Fortran nterface
+namespace {
 
-using multio::message::Peer;
+void sendField(const Metadata& metadata, const double* data, fortint* size,
+               const std::string& domain_name, const std::string& category) {
+    LOG_DEBUG_LIB(LibMultio) << " ***** Field metadata = " << metadata << std::endl;
+
+    LOG_DEBUG_LIB(LibMultio) << " ***** Field data = ";
+    print_buffer(data, *size);
+    LOG_DEBUG_LIB(LibMultio) << std::endl;
+
+    Peer client = IoTransport::instance().client();
+
+    eckit::Buffer buffer{(const char*)(data), (*size) * sizeof(double)};
+
+    Metadata md{metadata};
+    md.set("name", md.getString("param"));
+    md.set("category", category);
+    md.set("globalSize", IoTransport::instance().globalSize());
+    md.set("domainCount", IoTransport::instance().clientCount());
+    md.set("domain", domain_name);
+    Message msg{Message::Header{Message::Tag::Field, client, IoTransport::instance().server(),
+                               std::move(md)},
+                std::move(buffer)};
+
+    IoTransport::instance().transport().send(msg);
+}
+
+}  // namespace
+
+// C/Fortran nterface
 
 #ifdef __cplusplus
     extern "C" {
@@ -132,27 +248,26 @@ void set_multio_dimensions_(fortint* clients, fortint* servers, fortint* glfield
 }
 
 void open_multio_connection_() {
-    Peer client = IoTransport::instance().transport().localPeer();
-    Peer server{"thread",
-                std::hash<std::thread::id>{}(IoTransport::instance().listenerThread().get_id())};
+    IoTransport::instance().connect();
+
+    Peer client = IoTransport::instance().client();
+    const Peer& server = IoTransport::instance().server();
 
     Message open{Message::Header{Message::Tag::Open, client, server}, eckit::Buffer{"open"}};
     IoTransport::instance().transport().send(open);
 }
 
 void close_multio_connection_() {
-    Peer client = IoTransport::instance().transport().localPeer();
-    Peer server{"thread",
-                std::hash<std::thread::id>{}(IoTransport::instance().listenerThread().get_id())};
+    Peer client = IoTransport::instance().client();
+    const Peer& server = IoTransport::instance().server();
 
     Message close{Message::Header{Message::Tag::Close, client, server}, eckit::Buffer{"close"}};
     IoTransport::instance().transport().send(close);
 }
 
 void send_multio_step_complete_() {
-    Peer client = IoTransport::instance().transport().localPeer();
-    Peer server{"thread",
-                std::hash<std::thread::id>{}(IoTransport::instance().listenerThread().get_id())};
+    Peer client = IoTransport::instance().client();
+    const Peer& server = IoTransport::instance().server();
 
     Message close{Message::Header{Message::Tag::StepComplete, client, server}, eckit::Buffer{"flush"}};
     IoTransport::instance().transport().send(close);
@@ -161,12 +276,12 @@ void send_multio_step_complete_() {
 void open_multio_message_() {
     ASSERT(!IoTransport::instance().isOpen());
     IoTransport::instance().metadata() = Metadata{};
-    IoTransport::instance().open();
+    IoTransport::instance().isOpen() = true;
 }
 
 void close_multio_message_() {
     ASSERT(IoTransport::instance().isOpen());
-    IoTransport::instance().close();
+    IoTransport::instance().isOpen() = false;
 }
 
 void set_multio_bool_value_(const char* key, bool* value, int key_len) {
@@ -208,9 +323,8 @@ void send_multio_grib_template_(const void* grib_msg, fortint *words) {
     size_t len = (*words) * sizeof(fortint);
     eckit::Buffer buffer{(const char*)(grib_msg), len};
 
-    Peer client = IoTransport::instance().transport().localPeer();
-    Peer server{"thread",
-                std::hash<std::thread::id>{}(IoTransport::instance().listenerThread().get_id())};
+    Peer client = IoTransport::instance().client();
+    const Peer& server = IoTransport::instance().server();
 
     Metadata md{IoTransport::instance().metadata()};
     md.set("domainCount", IoTransport::instance().clientCount());
@@ -234,9 +348,8 @@ void send_multio_mapping_(const void* in_ptr, fortint* words, const char* name,
     const char* ptr = (const char*)(in_ptr);
     auto len = ((*words) / nb_clients) * sizeof(fortint);
     for (size_t ii = 0; ii != nb_clients; ++ii) {
-        Peer client = IoTransport::instance().transport().localPeer();
-        Peer server{"thread", std::hash<std::thread::id>{}(
-                                  IoTransport::instance().listenerThread().get_id())};
+        Peer client = IoTransport::instance().client();
+        const Peer& server = IoTransport::instance().server();
 
         eckit::Buffer buffer{ptr, len};
 
@@ -259,35 +372,63 @@ void send_multio_mapping_(const void* in_ptr, fortint* words, const char* name,
 
 void send_multio_field_(const double* data, fortint* size, const char* name, const char* cat,
                         fortint name_len, fortint cat_len) {
-    LOG_DEBUG_LIB(LibMultio) << " ***** Field metadata = " << IoTransport::instance().metadata() << std::endl;
+    sendField(IoTransport::instance().metadata(), data, size, std::string{name, name + name_len},
+              std::string{cat, cat + cat_len});
+}
 
-    LOG_DEBUG_LIB(LibMultio) << " ***** Field data = ";
-    print_buffer(data, *size);
-    LOG_DEBUG_LIB(LibMultio) << std::endl;
+// Message builders: each handle carries its own metadata, so that several threads can build and
+// send fields at the same time. A handle may be reused for any number of fields.
 
-    Peer client = IoTransport::instance().transport().localPeer();
-    Peer server{"thread",
-                std::hash<std::thread::id>{}(IoTransport::instance().listenerThread().get_id())};
-    std::string domain_name{name, name + name_len};
-    std::string category{cat, cat + cat_len};
+void multio_new_message_(fortint* handle) {
+    *handle = IoTransport::instance().builders().create();
+}
 
-    eckit::Buffer buffer{(const char*)(data), (*size) * sizeof(double)};
+void multio_delete_message_(fortint* handle) {
+    IoTransport::instance().builders().release(*handle);
+}
+
+void multio_message_set_bool_value_(fortint* handle, const char* key, bool* value, int key_len) {
+    std::string skey{key, key + key_len};
+    IoTransport::instance().builders().get(*handle).set(skey, *value);
+}
 
-    std::string field_id = multio::message::to_string(IoTransport::instance().metadata());
+void multio_message_set_int_value_(fortint* handle, const char* key, fortint* value, int key_len) {
+    std::string skey{key, key + key_len};
+    IoTransport::instance().builders().get(*handle).set(skey, *value);
+}
 
-    auto gribName = IoTransport::instance().metadata().getString("param");
+void multio_message_set_int_array_value_(fortint* handle, const char* key, fortint* data,
+                                         fortint* size, int key_len) {
+    std::string skey{key, key + key_len};
+    std::vector<int> vvalue{data, data + *size};
+    IoTransport::instance().builders().get(*handle).set(skey, vvalue);
+}
 
+void multio_message_set_real_value_(fortint* handle, const char* key, double* value,
+                                    int key_len) {
+    std::string skey{key, key + key_len};
+    IoTransport::instance().builders().get(*handle).set(skey, *value);
+}
 
-    Metadata md{IoTransport::instance().metadata()};
-    md.set("name", md.getString("param"));
-    md.set("category", category);
-    md.set("globalSize", IoTransport::instance().globalSize());
-    md.set("domainCount", IoTransport::instance().clientCount());
-    md.set("domain", domain_name);
-    Message msg{Message::Header{Message::Tag::Field, client, server, std::move(md)},
-                std::move(buffer)};
+void multio_message_set_real_array_value_(fortint* handle, const char* key, double* data,
+                                          fortint* size, int key_len) {
+    std::string skey{key, key + key_len};
+    std::vector<double> vvalue{data, data + *size};
+    IoTransport::instance().builders().get(*handle).set(skey, vvalue);
+}
 
-    IoTransport::instance().transport().send(msg);
+void multio_message_set_string_value_(fortint* handle, const char* key, const char* value,
+                                      int key_len, int val_len) {
+    std::string skey{key, key + key_len};
+    std::string svalue{value, value + val_len};
+    IoTransport::instance().builders().get(*handle).set(skey, svalue);
+}
+
+void multio_message_send_field_(fortint* handle, const double* data, fortint* size,
+                                const char* name, const char* cat, fortint name_len,
+                                fortint cat_len) {
+    sendField(IoTransport::instance().builders().get(*handle), data, size,
+              std::string{name, name + name_len}, std::string{cat, cat + cat_len});
 }
 
 #ifdef __cplusplus
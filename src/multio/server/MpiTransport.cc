@@ -10,6 +10,8 @@
 
 #include "MpiTransport.h"
 
+#include <mpi.h>
+
 #include <algorithm>
 
 #include "eckit/config/Resource.h"
@@ -18,6 +20,7 @@
 #include "eckit/serialisation/MemoryStream.h"
 
 #include "multio/util/ScopedTimer.h"
+#include "multio/util/Trace.h"
 #include "multio/util/print_buffer.h"
 
 namespace multio {
@@ -54,6 +57,19 @@ Message decodeMessage(eckit::Stream& stream) {
 
 }  // namespace
 
+bool MpiTransport::threadMultiple() {
+    // eckit::mpi does not expose the thread support level
+    int initialised = 0;
+    MPI_Initialized(&initialised);
+    if (not initialised) {
+        return false;
+    }
+
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    return provided == MPI_THREAD_MULTIPLE;
+}
+
 MpiTransport::MpiTransport(const eckit::Configuration& cfg) :
     Transport(cfg),
     local_{cfg.getString("group"), eckit::mpi::comm(cfg.getString("group").c_str()).rank()},
@@ -108,10 +124,7 @@ Message MpiTransport::receive() {
 }
 
 void MpiTransport::send(const Message& msg) {
-    eckit::Log::info() << pool_ << std::endl;
-
-    eckit::Log::info() << " *** Encode " << msg << " into stream for " << msg.destination()
-                       << std::endl;
+    MULTIO_TRACE(util::TraceLevel::Debug, "mpi-encode", msg.destination().id(), msg.size());
 
     msg.encode(pool_.getStream(msg));
 
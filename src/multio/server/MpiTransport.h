@@ -35,6 +35,10 @@ public:
     MpiTransport(const eckit::Configuration& config);
     ~MpiTransport();
 
+    /// Whether MPI provides MPI_THREAD_MULTIPLE, which sending from a thread other than the one
+    /// the application makes its own MPI calls from requires
+    static bool threadMultiple();
+
 private:
     Message receive() override;
 
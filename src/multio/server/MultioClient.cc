@@ -1,12 +1,16 @@
 
 #include "MultioClient.h"
 
+#include "eckit/config/Resource.h"
 #include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
 #include "eckit/filesystem/PathName.h"
 
 #include "multio/LibMultio.h"
 #include "multio/message/Message.h"
 #include "multio/server/MpiTransport.h"
+#include "multio/server/NodeAggregator.h"
+#include "multio/server/ServerPlacement.h"
 #include "multio/server/TcpTransport.h"
 
 using multio::message::Peer;
@@ -14,79 +18,233 @@ using multio::message::Peer;
 namespace multio {
 namespace server {
 
+namespace {
+
+bool asyncSends(const eckit::Configuration& config) {
+    if (not config.getBool("async", eckit::Resource<bool>("multioAsyncClient;$MULTIO_ASYNC_CLIENT",
+                                                          false))) {
+        return false;
+    }
+
+    // The model keeps making its own MPI calls while the background thread sends
+    if (config.getString("transport") == "mpi" && not MpiTransport::threadMultiple()) {
+        eckit::Log::warning() << "MultioClient: MPI does not provide MPI_THREAD_MULTIPLE, "
+                              << "sending synchronously instead of asynchronously" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
 MultioClient::MultioClient(const eckit::Configuration& config) :
     clientCount_{config.getUnsigned("clientCount")},
     serverCount_{config.getUnsigned("serverCount")},
     transport_(TransportFactory::instance().build(config.getString("transport"), config)),
-    serverPeers_{createServerPeers(config)} {
+    serverPeers_{createServerPeers(config)},
+    placement_{serverCount_ > 0 ? ServerPlacement::build(config, serverCount_) : nullptr},
+    async_{asyncSends(config)} {
     eckit::Log::debug<multio::LibMultio>() << config << std::endl;
+
+    if (config.getBool("node-aggregation", eckit::Resource<bool>(
+                                               "multioNodeAggregation;$MULTIO_NODE_AGGREGATION",
+                                               false))) {
+        auto transport = config.getString("transport");
+        if (transport != "mpi") {
+            throw eckit::UserError("Node aggregation requires the mpi transport, not " + transport,
+                                   Here());
+        }
+        node_.reset(new NodeAggregator{config});
+    }
+
+    if (placement_) {
+        eckit::Log::debug<multio::LibMultio>() << *placement_ << std::endl;
+    }
+
+    if (async_) {
+        pending_.reset(new eckit::Queue<Message>(config.getUnsigned("async-queue-size", 1024)));
+        progressThread_ = std::thread{&MultioClient::progress, this};
+    }
 }
 
-MultioClient::~MultioClient() = default;
+MultioClient::~MultioClient() {
+    if (progressThread_.joinable()) {
+        pending_->close();
+        progressThread_.join();
+    }
+
+    if (error_) {
+        try {
+            std::rethrow_exception(error_);
+        }
+        catch (const std::exception& e) {
+            eckit::Log::error() << "MultioClient: failed to send: " << e.what() << std::endl;
+        }
+    }
+}
+
+void MultioClient::openConnections() {
+    if (not forwarding()) {
+        return;
+    }
 
-void MultioClient::openConnections() const {
     auto client = transport_->localPeer();
     for (auto& server : serverPeers_) {
         Message msg{Message::Header{Message::Tag::Open, client, *server}};
-        transport_->send(msg);
+        send(std::move(msg));
     }
 }
 
-void MultioClient::closeConnections() const {
+void MultioClient::closeConnections() {
+    if (not forwarding()) {
+        return;
+    }
+
     auto client = transport_->localPeer();
     for (auto& server : serverPeers_) {
         Message msg{Message::Header{Message::Tag::Close, client, *server}};
-        transport_->send(msg);
+        send(std::move(msg));
     }
+
+    // The transport may be torn down once the connections are closed
+    wait();
 }
 
 void MultioClient::sendDomain(message::Metadata metadata, eckit::Buffer&& domain) {
+    if (node_ && not node_->aggregateDomain(metadata, domain)) {
+        return;
+    }
+
     Peer client = transport_->localPeer();
     for (auto& server : serverPeers_) {
         Message msg{Message::Header{Message::Tag::Domain, client, *server, std::move(metadata)},
                     domain};
 
-        transport_->send(msg);
+        send(std::move(msg));
     }
 }
 
 void MultioClient::sendField(message::Metadata metadata, eckit::Buffer&& field,
                              bool to_all_servers) {
+    std::string fieldId = message::to_string(metadata);
+    sendField(std::move(metadata), std::move(fieldId), std::move(field), to_all_servers);
+}
+
+void MultioClient::sendField(message::Metadata metadata, std::string&& fieldId,
+                             eckit::Buffer&& field, bool to_all_servers) {
+    if (node_) {
+        auto domainCount = metadata.getUnsigned("domainCount");
+        if (not node_->aggregateField(metadata, field)) {
+            return;
+        }
+        if (domainCount != node_->nodeCount()) {
+            fieldId = message::to_string(metadata);
+        }
+    }
+
     Peer client = transport_->localPeer();
-    std::string field_id = message::to_string(metadata);
 
     if (to_all_servers) {
         for (auto& server : serverPeers_) {
-            Message msg{Message::Header{Message::Tag::Field, client, *server, std::move(metadata)},
+            Message msg{Message::Header{Message::Tag::Field, client, *server,
+                                        message::Metadata{metadata}, std::string{fieldId}},
                         field};
 
-            transport_->send(msg);
+            send(std::move(msg));
         }
     }
     else {
-        // Choose server
-        std::ostringstream os;
-        os << metadata.getString("category") << metadata.getString("nemoParam")
-           << metadata.getString("param") << metadata.getLong("level");
-        auto id = std::hash<std::string>{}(os.str()) % serverCount_;
+        ASSERT(placement_);
+        auto id = placement_->select(metadata);
         ASSERT(id < serverPeers_.size());
 
-        Message msg{
-            Message::Header{Message::Tag::Field, client, *serverPeers_[id], std::move(metadata)},
-            std::move(field)};
+        Message msg{Message::Header{Message::Tag::Field, client, *serverPeers_[id],
+                                    std::move(metadata), std::move(fieldId)},
+                    std::move(field)};
 
-        transport_->send(msg);
+        send(std::move(msg));
     }
 }
 
-void MultioClient::sendStepComplete() const {
+void MultioClient::sendStepComplete() {
+    if (not forwarding()) {
+        return;
+    }
+
     auto client = transport_->localPeer();
     for (auto& server : serverPeers_) {
         Message msg{Message::Header{Message::Tag::StepComplete, client, *server}};
+        send(std::move(msg));
+    }
+}
+
+size_t MultioClient::domainCount() const {
+    return node_ ? node_->nodeCount() : clientCount_;
+}
+
+bool MultioClient::forwarding() const {
+    return not node_ || node_->leader();
+}
+
+void MultioClient::wait() {
+    if (not async_) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    sent_.wait(lock, [this]() { return sentCount_ == submittedCount_ || error_; });
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void MultioClient::send(Message&& msg) {
+    if (not async_) {
         transport_->send(msg);
+        return;
     }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        ++submittedCount_;
+    }
+
+    pending_->push(std::move(msg));
 }
 
+void MultioClient::progress() {
+    Message msg;
+    while (pending_->pop(msg) >= 0) {
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            failed = static_cast<bool>(error_);
+        }
+
+        std::exception_ptr error;
+        try {
+            // After a failure, keep draining the queue so that senders do not block on it
+            if (not failed) {
+                transport_->send(msg);
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (error && not error_) {
+            error_ = error;
+        }
+        ++sentCount_;
+        sent_.notify_all();
+    }
+}
 
 MultioClient::PeerList MultioClient::createServerPeers(const eckit::Configuration& config) {
     PeerList serverPeers;
@@ -103,11 +261,11 @@ MultioClient::PeerList MultioClient::createServerPeers(const eckit::Configuratio
     // For MPI -- this is dangerous as it requires having the same logic as in NEMO or IFS
     // Perhpas you want ot create an intercommunicator
     // Move this to the transport layer -- that should create the peerList and pass it back
-    if (transport == "mpi") {
+    if (transport == "mpi" || transport == "shm") {
         auto comm_size = clientCount_ + serverCount_;
         auto rank = clientCount_;
         while (rank != comm_size) {
-            serverPeers.emplace_back(new MpiPeer{group, rank++});
+            serverPeers.emplace_back(new Peer{group, rank++});
         }
 
         eckit::Log::debug<multio::LibMultio>()
@@ -11,9 +11,16 @@
 #ifndef multio_server_MultioClient_H
 #define multio_server_MultioClient_H
 
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "eckit/container/Queue.h"
+
+#include "multio/message/Message.h"
 #include "multio/message/Metadata.h"
 
 namespace eckit {
@@ -29,34 +36,75 @@ class Peer;
 
 namespace server {
 
+class NodeAggregator;
+class ServerPlacement;
 class Transport;
 
+/// Sends the messages of one client process to the servers.
+///
+/// With "async" set, messages are handed to a background thread that encodes and sends them, so
+/// that the model only pays for copying its data. At most "async-queue-size" messages wait to be
+/// sent; beyond that the caller blocks. wait() returns once everything handed over so far has
+/// been sent, and rethrows the first error of the background thread. With the mpi transport,
+/// sends stay synchronous unless MPI provides MPI_THREAD_MULTIPLE.
+
 class MultioClient {
 public:
     explicit MultioClient(const eckit::Configuration& config);
 
     ~MultioClient();
 
-    void openConnections() const;
+    void openConnections();
 
-    void closeConnections() const;
+    void closeConnections();
 
     void sendDomain(message::Metadata metadata, eckit::Buffer&& domain);
 
     void sendField(message::Metadata metadata, eckit::Buffer&& field, bool to_all_servers = false);
 
-    void sendStepComplete() const;
+    // As above, with the field id already rendered from metadata
+    void sendField(message::Metadata metadata, std::string&& fieldId, eckit::Buffer&& field,
+                   bool to_all_servers = false);
+
+    void sendStepComplete();
+
+    void wait();
+
+    /// The number of partials the servers receive for each field: the number of clients, or of
+    /// nodes with "node-aggregation"
+    size_t domainCount() const;
 
 private:
     using PeerList = std::vector<std::unique_ptr<message::Peer>>;
 
     PeerList createServerPeers(const eckit::Configuration& config);
 
+    void send(message::Message&& msg);
+
+    void progress();
+
     size_t clientCount_;
     size_t serverCount_;
 
     std::shared_ptr<Transport> transport_ = nullptr;
     PeerList serverPeers_;
+    std::unique_ptr<ServerPlacement> placement_;
+    std::unique_ptr<NodeAggregator> node_;
+
+    // Whether this client talks to the servers at all
+    bool forwarding() const;
+
+    // Asynchronous mode
+    const bool async_;
+    std::unique_ptr<eckit::Queue<message::Message>> pending_;
+
+    std::mutex mutex_;
+    std::condition_variable sent_;
+    size_t submittedCount_ = 0;
+    size_t sentCount_ = 0;
+    std::exception_ptr error_;
+
+    std::thread progressThread_;
 
 };
 
@@ -16,9 +16,12 @@
 
 #include "MultioNemo.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <set>
 #include <typeinfo>
+#include <vector>
 
 #include "eckit/config/YAMLConfiguration.h"
 #include "eckit/exception/Exceptions.h"
@@ -52,6 +55,83 @@ struct GribData {
     std::string gridType;
 };
 
+// Keys that change from one write of a field to the next. They are patched into a pre-rendered
+// field id, so the rest of the metadata is only serialised when it changes.
+const std::vector<std::string> patchedKeys{"step", "level"};
+
+// Stands in for the value of patchedKeys[i] while a template is rendered
+long placeholder(size_t i) {
+    return 1987654320 + static_cast<long>(i);
+}
+
+/// The metadata of one field, rendered once with placeholders for the patched keys
+class FieldTemplate {
+public:
+    // patched[i] tells whether patchedKeys[i] is set, to an integer, in metadata
+    FieldTemplate(Metadata&& metadata, const std::vector<bool>& patched, size_t generation) :
+        metadata_{std::move(metadata)}, generation_{generation} {
+        std::vector<std::pair<size_t, size_t>> holes;  // Position in the text and key
+        for (size_t i = 0; i != patchedKeys.size(); ++i) {
+            if (patched[i]) {
+                metadata_.set(patchedKeys[i], placeholder(i));
+                holes.emplace_back(0, i);
+                patched_.push_back(i);
+            }
+        }
+
+        const auto text = multio::message::to_string(metadata_);
+        for (auto& hole : holes) {
+            const auto value = std::to_string(placeholder(hole.second));
+            hole.first = text.find(value);
+            if (hole.first == std::string::npos ||
+                text.find(value, hole.first + 1) != std::string::npos) {
+                return;  // Leaves segments_ empty: render the whole metadata instead
+            }
+        }
+        std::sort(begin(holes), end(holes));
+
+        size_t offset = 0;
+        for (const auto& hole : holes) {
+            segments_.push_back(text.substr(offset, hole.first - offset));
+            keys_.push_back(hole.second);
+            offset = hole.first + std::to_string(placeholder(hole.second)).size();
+        }
+        segments_.push_back(text.substr(offset));
+    }
+
+    size_t generation() const { return generation_; }
+
+    Metadata metadata(const std::vector<long>& values) const {
+        Metadata md{metadata_};
+        for (auto i : patched_) {
+            md.set(patchedKeys[i], values[i]);
+        }
+        return md;
+    }
+
+    std::string fieldId(const Metadata& md, const std::vector<long>& values) const {
+        if (segments_.empty()) {
+            return multio::message::to_string(md);
+        }
+
+        std::string id = segments_[0];
+        for (size_t i = 0; i != keys_.size(); ++i) {
+            id += std::to_string(values[keys_[i]]);
+            id += segments_[i + 1];
+        }
+        return id;
+    }
+
+private:
+    Metadata metadata_;
+    size_t generation_;
+    std::vector<size_t> patched_;
+
+    // The field id is segments_ interleaved with the values of patchedKeys[keys_[i]]
+    std::vector<std::string> segments_;
+    std::vector<size_t> keys_;
+};
+
 }  // namespace
 
 class MultioNemo {
@@ -63,6 +143,17 @@ class MultioNemo {
 
     Metadata metadata_;
 
+    // Field templates are rebuilt when a key other than the patched ones changes
+    size_t generation_ = 0;
+    std::vector<long> patchedValues_ = std::vector<long>(patchedKeys.size(), 0);
+    std::vector<bool> patched_ = std::vector<bool>(patchedKeys.size(), false);
+    std::map<std::string, FieldTemplate> templates_;
+
+    // Last value set for each key. NEMO sets most keys before every write, so only a change of
+    // value invalidates the templates.
+    std::map<std::string, int> intValues_;
+    std::map<std::string, std::string> stringValues_;
+
     std::unique_ptr<MultioClient> multioClient_ = nullptr;
     std::unique_ptr<MultioServer> multioServer_ = nullptr;
 
@@ -90,10 +181,48 @@ public:
         return *multioClient_;
     }
 
-    Metadata& metadata() {
+    const Metadata& metadata() const {
         return metadata_;
     }
 
+    void setMetadata(const std::string& key, int value) {
+        auto it = std::find(begin(patchedKeys), end(patchedKeys), key);
+        if (it != end(patchedKeys)) {
+            auto i = static_cast<size_t>(it - begin(patchedKeys));
+            patchedValues_[i] = value;
+            if (not patched_[i]) {
+                patched_[i] = true;
+                ++generation_;
+            }
+        }
+        else {
+            auto current = intValues_.find(key);
+            if (current != end(intValues_) && current->second == value) {
+                return;
+            }
+            ++generation_;
+        }
+        intValues_[key] = value;
+        stringValues_.erase(key);
+        metadata_.set(key, value);
+    }
+
+    void setMetadata(const std::string& key, const std::string& value) {
+        auto current = stringValues_.find(key);
+        if (current != end(stringValues_) && current->second == value) {
+            return;
+        }
+
+        auto it = std::find(begin(patchedKeys), end(patchedKeys), key);
+        if (it != end(patchedKeys)) {
+            patched_[static_cast<size_t>(it - begin(patchedKeys))] = false;
+        }
+        ++generation_;
+        stringValues_[key] = value;
+        intValues_.erase(key);
+        metadata_.set(key, value);
+    }
+
     int initClient(const std::string& oce_str, int parent_comm) {
 
         eckit::mpi::addComm("nemo", parent_comm);
@@ -107,6 +236,7 @@ public:
         serverCount_ = eckit::mpi::comm("nemo").size() - clientCount_;
 
         config_.set("group", "nemo");
+        config_.set("clientGroup", oce_str);
         config_.set("clientCount", clientCount_);
         config_.set("serverCount", serverCount_);
 
@@ -130,7 +260,7 @@ public:
         Metadata md;
         md.set("name", dname);
         md.set("category", "structured");
-        md.set("domainCount", clientCount_);
+        md.set("domainCount", client().domainCount());
         client().sendDomain(std::move(md), std::move(domain_def));
     }
 
@@ -142,16 +272,37 @@ public:
 
         ASSERT(isActive(fname));
 
-        metadata_.set("name", fname);
-        metadata_.set("nemoParam", fname);
-        metadata_.set("param", paramMap_.get(fname).param);
-        metadata_.set("gridSubtype", paramMap_.get(fname).gridType);
-        metadata_.set("domainCount", clientCount_);
-        metadata_.set("domain", paramMap_.get(fname).gridType);
+        const auto& templ = fieldTemplate(fname);
+        auto md = templ.metadata(patchedValues_);
+        auto fieldId = templ.fieldId(md, patchedValues_);
 
         eckit::Buffer field_vals{reinterpret_cast<const char*>(data), bytes};
 
-        MultioNemo::instance().client().sendField(metadata_, std::move(field_vals), to_all_servers);
+        client().sendField(std::move(md), std::move(fieldId), std::move(field_vals),
+                           to_all_servers);
+    }
+
+    const FieldTemplate& fieldTemplate(const std::string& fname) {
+        auto it = templates_.find(fname);
+        if (it != end(templates_) && it->second.generation() == generation_) {
+            return it->second;
+        }
+
+        const auto& grib = paramMap_.get(fname);
+
+        Metadata md{metadata_};
+        md.set("name", fname);
+        md.set("nemoParam", fname);
+        md.set("param", grib.param);
+        md.set("gridSubtype", grib.gridType);
+        md.set("domainCount", client().domainCount());
+        md.set("domain", grib.gridType);
+
+        if (it != end(templates_)) {
+            templates_.erase(it);
+        }
+        FieldTemplate templ{std::move(md), patched_, generation_};
+        return templates_.emplace(fname, std::move(templ)).first->second;
     }
 
     bool useServer() const {
@@ -179,6 +330,12 @@ void multio_write_step_complete() {
     MultioNemo::instance().client().sendStepComplete();
 }
 
+void multio_wait() {
+    if (MultioNemo::instance().useServer()) {
+        MultioNemo::instance().client().wait();
+    }
+}
+
 int multio_init_client(const char* name, int parent_comm) {
     return MultioNemo::instance().initClient(name, parent_comm);
 }
@@ -189,12 +346,12 @@ void multio_init_server(int nemo_comm) {
 
 void multio_metadata_set_int_value(const char* key, int value) {
     std::string skey{key};
-    MultioNemo::instance().metadata().set(skey, value);
+    MultioNemo::instance().setMetadata(skey, value);
 }
 
 void multio_metadata_set_string_value(const char* key, const char* value) {
     std::string skey{key}, svalue{value};
-    MultioNemo::instance().metadata().set(skey, svalue);
+    MultioNemo::instance().setMetadata(skey, svalue);
 }
 
 void multio_set_domain(const char* name, int* data, int size) {
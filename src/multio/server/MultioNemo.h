@@ -23,6 +23,9 @@ void multio_close_connections();
 
 void multio_write_step_complete();
 
+// Waits until every field written so far has been sent. Only blocks with an asynchronous client.
+void multio_wait();
+
 int multio_init_client(const char* name, int parent_comm);
 
 void multio_init_server(int nemo_comm);
@@ -0,0 +1,185 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "NodeAggregator.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "eckit/config/Configuration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/mpi/Comm.h"
+
+#include "multio/LibMultio.h"
+#include "multio/domain/Domain.h"
+
+namespace multio {
+namespace server {
+
+namespace {
+
+std::string hostname() {
+    char name[256] = {0};
+    if (::gethostname(name, sizeof(name) - 1) != 0) {
+        throw eckit::FailedSystemCall("gethostname", Here());
+    }
+    return name;
+}
+
+// Ranks whose host names collide share a "node". The result is still correct, only less local.
+const eckit::mpi::Comm& nodeComm(const eckit::Configuration& config) {
+    auto group = config.getString("clientGroup");
+    auto colour = static_cast<int>(std::hash<std::string>{}(hostname()) & 0x7fffffff);
+    return eckit::mpi::comm(group.c_str()).split(colour, group + "-node");
+}
+
+std::unique_ptr<domain::Domain> makeDomain(const std::string& category,
+                                           std::vector<int32_t>&& definition) {
+    if (category == "unstructured") {
+        return std::unique_ptr<domain::Domain>{new domain::Unstructured{std::move(definition)}};
+    }
+    if (category == "structured") {
+        return std::unique_ptr<domain::Domain>{new domain::Structured{std::move(definition)}};
+    }
+    throw eckit::UserError("Node aggregation does not support domains of category " + category,
+                           Here());
+}
+
+}  // namespace
+
+NodeAggregator::NodeAggregator(const eckit::Configuration& config) :
+    comm_{nodeComm(config)}, leader_{comm_.rank() == 0} {
+    size_t leaders = leader_ ? 1 : 0;
+    eckit::mpi::comm(config.getString("clientGroup").c_str())
+        .allReduce(leaders, nodeCount_, eckit::mpi::sum());
+
+    LOG_DEBUG_LIB(LibMultio) << "Node aggregation: " << comm_.size() << " ranks on this node, "
+                             << nodeCount_ << " nodes" << std::endl;
+}
+
+std::vector<int> NodeAggregator::gatherCounts(size_t count) const {
+    std::vector<int> counts;
+    comm_.gather(static_cast<int>(count), counts, 0);
+    return counts;
+}
+
+template <typename T>
+std::vector<T> NodeAggregator::gather(const T* data, size_t count,
+                                      const std::vector<int>& counts) const {
+    std::vector<T> all;
+    std::vector<int> displs;
+    if (leader_) {
+        displs.resize(counts.size());
+        int total = 0;
+        for (size_t i = 0; i != counts.size(); ++i) {
+            displs[i] = total;
+            total += counts[i];
+        }
+        all.resize(static_cast<size_t>(total));
+    }
+
+    comm_.gatherv(data, count, all.data(), counts.data(), displs.data(), 0);
+    return all;
+}
+
+bool NodeAggregator::aggregateDomain(message::Metadata& metadata, eckit::Buffer& domain) {
+    const size_t count = domain.size() / sizeof(int32_t);
+    auto counts = gatherCounts(count);
+    auto all = gather(static_cast<const int32_t*>(domain.data()), count, counts);
+    if (not leader_) {
+        return false;
+    }
+
+    auto category = metadata.getString("category");
+
+    std::vector<std::vector<int32_t>> indices;
+    std::vector<int32_t> definition;
+    auto it = all.begin();
+    for (auto count : counts) {
+        auto local = makeDomain(category, std::vector<int32_t>{it, it + count});
+        it += count;
+
+        indices.push_back(local->global_indices());
+        for (auto index : indices.back()) {
+            if (index >= 0) {
+                definition.push_back(index);
+            }
+        }
+    }
+    indices_[metadata.getString("name")] = std::move(indices);
+
+    metadata.set("category", "unstructured");
+    metadata.set("domainCount", nodeCount_);
+
+    domain.resize(definition.size() * sizeof(int32_t));
+    std::memcpy(domain.data(), definition.data(), domain.size());
+    return true;
+}
+
+bool NodeAggregator::aggregateField(message::Metadata& metadata, eckit::Buffer& field) {
+    const size_t count = field.size() / sizeof(double);
+
+    // The leader knows the size of every partial from the domains, so one collective suffices
+    std::vector<int> counts;
+    const std::vector<std::vector<int32_t>>* found = nullptr;
+    size_t levelCount = 1;
+    if (leader_) {
+        auto name = metadata.getString("domain");
+        auto it = indices_.find(name);
+        ASSERT_MSG(it != indices_.end(), "No node aggregation for domain " + name);
+        found = &it->second;
+
+        levelCount = static_cast<size_t>(metadata.getLong("levelCount", 1));
+        for (const auto& points : *found) {
+            counts.push_back(static_cast<int>(points.size() * levelCount));
+        }
+        ASSERT(counts.size() == comm_.size());
+        ASSERT(static_cast<size_t>(counts[0]) == count);
+    }
+
+    auto all = gather(static_cast<const double*>(field.data()), count, counts);
+    if (not leader_) {
+        return false;
+    }
+
+    const auto& indices = *found;
+
+    // Same layout as an unstructured partial: level by level, each in the order of the
+    // definition built by aggregateDomain
+    std::vector<double> values;
+    for (size_t level = 0; level != levelCount; ++level) {
+        const double* rank = all.data();
+        for (size_t r = 0; r != counts.size(); ++r) {
+            const auto& points = indices[r];
+            const double* data = rank + level * points.size();
+            for (size_t p = 0; p != points.size(); ++p) {
+                if (points[p] >= 0) {
+                    values.push_back(data[p]);
+                }
+            }
+            rank += counts[r];
+        }
+    }
+
+    metadata.set("domainCount", nodeCount_);
+
+    field.resize(values.size() * sizeof(double));
+    std::memcpy(field.data(), values.data(), field.size());
+    return true;
+}
+
+}  // namespace server
+}  // namespace multio
@@ -0,0 +1,84 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_server_NodeAggregator_H
+#define multio_server_NodeAggregator_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+
+#include "multio/message/Metadata.h"
+
+namespace eckit {
+class Buffer;
+class Configuration;
+namespace mpi {
+class Comm;
+}
+}  // namespace eckit
+
+namespace multio {
+namespace server {
+
+/// Merges the partial fields of the client ranks on one node before they are sent, so that a
+/// server receives one message per node rather than one per rank.
+///
+/// The clients, which must form the MPI communicator named by "clientGroup", are grouped by
+/// host. The lowest rank of each node is its leader. Domains and fields are gathered onto the
+/// leader, which sends them on as a single unstructured partial covering the points owned by
+/// the node; the other ranks send nothing. Every call is collective over the node, so all
+/// clients must write the same fields in the same order. A field takes a single gatherv, sized
+/// by the leader from the domains gathered before.
+///
+/// The gathers run on the thread that calls MultioClient, before any "async" background thread
+/// takes over, so the model waits for them.
+
+class NodeAggregator : private eckit::NonCopyable {
+public:
+    NodeAggregator(const eckit::Configuration& config);
+
+    bool leader() const { return leader_; }
+
+    /// The number of partials the servers receive for each field
+    size_t nodeCount() const { return nodeCount_; }
+
+    /// Returns true on the leader, with domain replaced by the node's definition
+    bool aggregateDomain(message::Metadata& metadata, eckit::Buffer& domain);
+
+    /// Returns true on the leader, with field replaced by the node's partial field
+    bool aggregateField(message::Metadata& metadata, eckit::Buffer& field);
+
+private:
+    // Gathers the count of every rank onto the leader
+    std::vector<int> gatherCounts(size_t count) const;
+
+    // Gathers the data of every rank onto the leader, which must pass the count of each rank
+    template <typename T>
+    std::vector<T> gather(const T* data, size_t count, const std::vector<int>& counts) const;
+
+    const eckit::mpi::Comm& comm_;
+
+    bool leader_;
+    size_t nodeCount_ = 0;
+
+    // On the leader: for each domain name, the global index of every local point of each rank on
+    // the node, -1 for points the rank does not own
+    std::map<std::string, std::vector<std::vector<int32_t>>> indices_;
+};
+
+}  // namespace server
+}  // namespace multio
+
+#endif
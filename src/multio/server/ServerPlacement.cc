@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "ServerPlacement.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "eckit/config/Configuration.h"
+#include "eckit/exception/Exceptions.h"
+
+namespace multio {
+namespace server {
+
+namespace {
+
+// FNV-1a: unlike std::hash, it gives the same value in every build, so clients built
+// differently still agree
+uint64_t hash(const std::string& text) {
+    uint64_t h = 14695981039346656037ull;
+    for (auto c : text) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::string fieldKey(const message::Metadata& metadata) {
+    return metadata.getString("category") + metadata.getString("nemoParam") +
+           metadata.getString("param");
+}
+
+class HashPlacement final : public ServerPlacement {
+public:
+    HashPlacement(size_t serverCount) : serverCount_{serverCount} {}
+
+private:
+    size_t select(const message::Metadata& metadata) const override {
+        auto key = fieldKey(metadata) + std::to_string(metadata.getLong("level", 0));
+        return hash(key) % serverCount_;
+    }
+
+    void print(std::ostream& os) const override {
+        os << "HashPlacement(servers=" << serverCount_ << ")";
+    }
+
+    const size_t serverCount_;
+};
+
+class SpreadLevelsPlacement final : public ServerPlacement {
+public:
+    SpreadLevelsPlacement(size_t serverCount) : serverCount_{serverCount} {}
+
+private:
+    size_t select(const message::Metadata& metadata) const override {
+        auto level = static_cast<uint64_t>(std::max(metadata.getLong("level", 0), 0L));
+        return (hash(fieldKey(metadata)) + level) % serverCount_;
+    }
+
+    void print(std::ostream& os) const override {
+        os << "SpreadLevelsPlacement(servers=" << serverCount_ << ")";
+    }
+
+    const size_t serverCount_;
+};
+
+class ConsistentHashPlacement final : public ServerPlacement {
+public:
+    ConsistentHashPlacement(size_t serverCount, size_t virtualNodes,
+                            const std::vector<double>& weights) :
+        serverCount_{serverCount} {
+        if (not weights.empty() && weights.size() != serverCount) {
+            throw eckit::UserError("Expected " + std::to_string(serverCount) +
+                                       " server weights, got " + std::to_string(weights.size()),
+                                   Here());
+        }
+
+        for (size_t server = 0; server != serverCount; ++server) {
+            auto weight = weights.empty() ? 1.0 : weights[server];
+            auto points = std::max<size_t>(1, static_cast<size_t>(weight * virtualNodes + 0.5));
+            for (size_t point = 0; point != points; ++point) {
+                ring_[hash("server-" + std::to_string(server) + "-" + std::to_string(point))] =
+                    server;
+            }
+        }
+    }
+
+private:
+    size_t select(const message::Metadata& metadata) const override {
+        auto key = fieldKey(metadata) + std::to_string(metadata.getLong("level", 0));
+        auto it = ring_.lower_bound(hash(key));
+        return it == ring_.end() ? ring_.begin()->second : it->second;
+    }
+
+    void print(std::ostream& os) const override {
+        os << "ConsistentHashPlacement(servers=" << serverCount_ << ",points=" << ring_.size()
+           << ")";
+    }
+
+    const size_t serverCount_;
+    std::map<uint64_t, size_t> ring_;
+};
+
+}  // namespace
+
+std::unique_ptr<ServerPlacement> ServerPlacement::build(const eckit::Configuration& config,
+                                                        size_t serverCount) {
+    ASSERT(serverCount > 0);
+
+    auto name = config.getString("server-placement", "hash");
+    if (name == "hash") {
+        return std::unique_ptr<ServerPlacement>{new HashPlacement{serverCount}};
+    }
+    if (name == "spread-levels") {
+        return std::unique_ptr<ServerPlacement>{new SpreadLevelsPlacement{serverCount}};
+    }
+    if (name == "consistent-hash") {
+        std::vector<double> weights;
+        if (config.has("server-weights")) {
+            weights = config.getDoubleVector("server-weights");
+        }
+        return std::unique_ptr<ServerPlacement>{new ConsistentHashPlacement{
+            serverCount, config.getUnsigned("virtual-nodes", 64), weights}};
+    }
+
+    throw eckit::UserError("Unknown server placement '" + name +
+                               "', expected 'hash', 'spread-levels' or 'consistent-hash'",
+                           Here());
+}
+
+}  // namespace server
+}  // namespace multio
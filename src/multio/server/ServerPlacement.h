@@ -0,0 +1,63 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_server_ServerPlacement_H
+#define multio_server_ServerPlacement_H
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "eckit/memory/NonCopyable.h"
+
+#include "multio/message/Metadata.h"
+
+namespace eckit {
+class Configuration;
+}
+
+namespace multio {
+namespace server {
+
+/// Chooses the server that receives a field. Every client of a field must choose the same
+/// server, so that the server can aggregate it, so policies only depend on the metadata that
+/// identifies the field and on the configuration.
+///
+/// "hash" hashes category, nemoParam, param and level over the servers. "spread-levels" starts
+/// each field at a hashed server and puts successive levels on successive servers, so the
+/// levels of a 3-D field are spread evenly. "consistent-hash" places fields on a hash ring with
+/// "virtual-nodes" points per server, scaled by the optional "server-weights".
+
+class ServerPlacement : private eckit::NonCopyable {
+public:  // methods
+    /// The policy is named by "server-placement", "hash" by default
+    static std::unique_ptr<ServerPlacement> build(const eckit::Configuration& config,
+                                                  size_t serverCount);
+
+    virtual ~ServerPlacement() = default;
+
+    /// Returns an index in [0, serverCount)
+    virtual size_t select(const message::Metadata& metadata) const = 0;
+
+private:  // methods
+    virtual void print(std::ostream& os) const = 0;
+
+    friend std::ostream& operator<<(std::ostream& os, const ServerPlacement& placement) {
+        placement.print(os);
+        return os;
+    }
+};
+
+}  // namespace server
+}  // namespace multio
+
+#endif
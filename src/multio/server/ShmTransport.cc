@@ -0,0 +1,536 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "ShmTransport.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/maths/Functions.h"
+#include "eckit/memory/NonCopyable.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/serialisation/MemoryStream.h"
+
+#include "multio/LibMultio.h"
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "The shared memory transport needs lock-free atomics");
+
+namespace multio {
+namespace server {
+
+namespace {
+
+Message decodeMessage(eckit::Stream& stream) {
+    unsigned t;
+    stream >> t;
+
+    std::string src_grp;
+    stream >> src_grp;
+    size_t src_id;
+    stream >> src_id;
+
+    std::string dest_grp;
+    stream >> dest_grp;
+    size_t dest_id;
+    stream >> dest_id;
+
+    std::string fieldId;
+    stream >> fieldId;
+
+    unsigned long sz;
+    stream >> sz;
+
+    eckit::Buffer buffer(sz);
+    stream >> buffer;
+
+    return Message{Message::Header{static_cast<Message::Tag>(t), ShmPeer{src_grp, src_id},
+                                   ShmPeer{dest_grp, dest_id}, std::move(fieldId)},
+                   std::move(buffer)};
+}
+
+// Futexes in shared memory must not be process-private
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, long milliseconds) {
+    struct timespec timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_nsec = (milliseconds % 1000) * 1000000;
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout,
+              nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+              0);
+}
+
+uint64_t round8(uint64_t n) {
+    return (n + 7) & ~uint64_t{7};
+}
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Unique to this run of the job, so that jobs on the same node keep to their own segments
+std::string jobToken(const eckit::mpi::Comm& comm) {
+    uint64_t token = 0;
+    if (comm.rank() == 0) {
+        const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+        token = static_cast<uint64_t>(now.count()) ^ (static_cast<uint64_t>(::getpid()) << 40);
+    }
+    comm.broadcast(token, 0);
+
+    std::ostringstream os;
+    os << std::hex << token;
+    return os.str();
+}
+
+// Segments are always created afresh, and their creator initialises the header
+
+struct ControlHeader {
+    alignas(64) std::atomic<uint32_t> sequence;  // Bumped by clients after every message
+    std::atomic<uint32_t> serverWaiting;
+    alignas(64) std::atomic<uint32_t> announced;  // Number of clients with a ring
+    alignas(64) std::atomic<uint32_t> ready;  // Set by the server once the rest is initialised
+    // Followed by one slot per client, holding the rank of the client plus one
+};
+
+struct RingHeader {
+    alignas(64) std::atomic<uint64_t> head;  // Advanced by the server
+    alignas(64) std::atomic<uint64_t> tail;  // Advanced by the client
+    alignas(64) std::atomic<uint32_t> released;  // Bumped by the server when it frees space
+    std::atomic<uint32_t> clientWaiting;
+};
+
+const size_t headerSize = 256;
+static_assert(sizeof(ControlHeader) <= headerSize && sizeof(RingHeader) <= headerSize,
+              "Shared memory headers are too large");
+
+// Marks the unused end of the ring when a message does not fit before wrapping around
+const uint64_t wrapMarker = ~uint64_t{0};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class SharedMemory : private eckit::NonCopyable {
+public:
+    enum class Mode
+    {
+        Create,  // Replaces any segment of the same name with a fresh, zero-filled one
+        Open     // Waits up to timeout seconds for the creator to make and size the segment
+    };
+
+    SharedMemory(const std::string& name, size_t size, Mode mode, unsigned timeout = 0) :
+        name_{name}, size_{size} {
+        int fd = (mode == Mode::Create) ? create() : open(timeout);
+
+        auto p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw eckit::FailedSystemCall("mmap " + name_, Here(), errno);
+        }
+        data_ = static_cast<char*>(p);
+    }
+
+    ~SharedMemory() { ::munmap(data_, size_); }
+
+    char* data() const { return data_; }
+
+    void unlink() const { ::shm_unlink(name_.c_str()); }
+
+private:
+    int create() {
+        // A segment left over from a crashed run may hold stale indices
+        ::shm_unlink(name_.c_str());
+
+        int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            throw eckit::FailedSystemCall("shm_open " + name_, Here(), errno);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            ::close(fd);
+            throw eckit::FailedSystemCall("ftruncate " + name_, Here(), errno);
+        }
+        return fd;
+    }
+
+    int open(unsigned timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+        while (true) {
+            int fd = ::shm_open(name_.c_str(), O_RDWR, 0600);
+            if (fd < 0 && errno != ENOENT) {
+                throw eckit::FailedSystemCall("shm_open " + name_, Here(), errno);
+            }
+
+            if (fd >= 0) {
+                struct stat st;
+                if (::fstat(fd, &st) != 0) {
+                    ::close(fd);
+                    throw eckit::FailedSystemCall("fstat " + name_, Here(), errno);
+                }
+                if (static_cast<size_t>(st.st_size) == size_) {
+                    return fd;
+                }
+                ::close(fd);
+
+                // Zero bytes means the creator has not sized it yet
+                if (st.st_size != 0) {
+                    throw eckit::UserError("Shared memory segment " + name_ + " has " +
+                                               std::to_string(st.st_size) + " bytes, expected " +
+                                               std::to_string(size_),
+                                           Here());
+                }
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw eckit::SeriousBug("Shared memory segment " + name_ +
+                                            " was not created within " + std::to_string(timeout) +
+                                            " seconds",
+                                        Here());
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    const std::string name_;
+    const size_t size_;
+    char* data_ = nullptr;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Single-producer, single-consumer ring of length-prefixed records
+class ShmRing : private eckit::NonCopyable {
+public:
+    /// The client creates the ring; the server opens it once the client has announced it
+    ShmRing(const std::string& name, size_t capacity, SharedMemory::Mode mode) :
+        shm_{name, headerSize + capacity, mode},
+        header_{reinterpret_cast<RingHeader*>(shm_.data())},
+        data_{shm_.data() + headerSize},
+        capacity_{capacity} {
+        if (mode == SharedMemory::Mode::Create) {
+            header_->head.store(0);
+            header_->tail.store(0);
+            header_->released.store(0);
+            header_->clientWaiting.store(0);
+        }
+    }
+
+    // Client side
+
+    /// Returns room for at least maxBytes, waiting for the server to free space if needed
+    char* reserve(size_t maxBytes) {
+        const uint64_t needed = 8 + round8(maxBytes);
+        if (needed > capacity_) {
+            throw eckit::UserError("Message of up to " + std::to_string(maxBytes) +
+                                       " bytes does not fit into a shared memory ring of " +
+                                       std::to_string(capacity_) + " bytes",
+                                   Here());
+        }
+
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        while (true) {
+            const uint64_t offset = tail & (capacity_ - 1);
+            const uint64_t contiguous = capacity_ - offset;
+
+            // Only waits for the end of the ring before wrapping: waiting for that and the record
+            // together could ask for more than the capacity
+            waitForSpace(tail, std::min(contiguous, needed));
+
+            if (contiguous >= needed) {
+                reserved_ = tail;
+                return data_ + offset + 8;
+            }
+
+            *reinterpret_cast<uint64_t*>(data_ + offset) = wrapMarker;
+            tail += contiguous;
+            header_->tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    void commit(size_t bytes) {
+        *reinterpret_cast<uint64_t*>(data_ + (reserved_ & (capacity_ - 1))) = bytes;
+        header_->tail.store(reserved_ + 8 + round8(bytes), std::memory_order_release);
+    }
+
+    // Server side
+
+    bool peek(const char*& data, size_t& bytes) {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        while (head != header_->tail.load(std::memory_order_acquire)) {
+            const uint64_t offset = head & (capacity_ - 1);
+            const uint64_t length = *reinterpret_cast<const uint64_t*>(data_ + offset);
+
+            if (length != wrapMarker) {
+                data = data_ + offset + 8;
+                bytes = static_cast<size_t>(length);
+                return true;
+            }
+
+            head += capacity_ - offset;
+            release(head);
+        }
+        return false;
+    }
+
+    void pop(size_t bytes) {
+        release(header_->head.load(std::memory_order_relaxed) + 8 + round8(bytes));
+    }
+
+    const SharedMemory& memory() const { return shm_; }
+
+private:
+    void waitForSpace(uint64_t tail, uint64_t bytes) {
+        auto available = [this, tail]() {
+            return capacity_ - (tail - header_->head.load(std::memory_order_acquire));
+        };
+
+        while (available() < bytes) {
+            const auto released = header_->released.load();
+            header_->clientWaiting.store(1);
+            if (available() < bytes) {
+                futexWait(header_->released, released, 100);
+            }
+            header_->clientWaiting.store(0);
+        }
+    }
+
+    void release(uint64_t head) {
+        header_->head.store(head, std::memory_order_release);
+        header_->released.fetch_add(1);
+        if (header_->clientWaiting.load() != 0) {
+            futexWake(header_->released);
+        }
+    }
+
+    SharedMemory shm_;
+    RingHeader* header_;
+    char* data_;
+    const uint64_t capacity_;
+
+    uint64_t reserved_ = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct ShmTransport::Outgoing {
+    SharedMemory control;
+    ShmRing ring;
+
+    Outgoing(const std::string& controlName, size_t controlSize, const std::string& ringName,
+             size_t ringSize, unsigned timeout) :
+        control{controlName, controlSize, SharedMemory::Mode::Open, timeout},
+        ring{ringName, ringSize, SharedMemory::Mode::Create} {}
+
+    ControlHeader& header() { return *reinterpret_cast<ControlHeader*>(control.data()); }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+ShmPeer::ShmPeer(const std::string& group, size_t rank) : Peer{group, rank} {}
+
+ShmTransport::ShmTransport(const eckit::Configuration& cfg) :
+    Transport(cfg),
+    local_{cfg.getString("group"), eckit::mpi::comm(cfg.getString("group").c_str()).rank()},
+    prefix_{"/" + cfg.getString("name", "multio") + "-" + local_.group() + "-" +
+            jobToken(eckit::mpi::comm(local_.group().c_str()))},
+    ringSize_{nextPowerOfTwo(cfg.getUnsigned(
+        "buffer-size",
+        eckit::Resource<size_t>("multioShmBufferSize;$MULTIO_SHM_BUFFER_SIZE", 32 * 1024 * 1024)))},
+    maxClients_{cfg.getUnsigned("max-clients", 1024)},
+    openTimeout_{static_cast<unsigned>(cfg.getUnsigned("open-timeout", 300))} {}
+
+ShmTransport::~ShmTransport() {
+    if (control_) {
+        for (const auto& ring : incoming_) {
+            ring->memory().unlink();
+        }
+        control_->unlink();
+    }
+}
+
+Message ShmTransport::receive() {
+    auto& header = *reinterpret_cast<ControlHeader*>(control().data());
+
+    Message msg;
+    while (not nextMessage(msg)) {
+        // Clients bump the sequence after publishing, so a message that arrives after this
+        // load either shows up in the second look or makes the futex wait return at once
+        const auto sequence = header.sequence.load();
+        header.serverWaiting.store(1);
+        if (not nextMessage(msg)) {
+            futexWait(header.sequence, sequence, 1000);
+            header.serverWaiting.store(0);
+            continue;
+        }
+        header.serverWaiting.store(0);
+        break;
+    }
+
+    return msg;
+}
+
+void ShmTransport::send(const Message& msg) {
+    auto& out = outgoing(msg.destination());
+
+    // Add 4K for header/footer etc. Should be plenty
+    const auto maxBytes = eckit::round(msg.size(), 8) + 4096;
+
+    eckit::MemoryStream stream{out.ring.reserve(maxBytes), maxBytes};
+    msg.encode(stream);
+    out.ring.commit(static_cast<size_t>(stream.bytesWritten()));
+
+    auto& header = out.header();
+    header.sequence.fetch_add(1);
+    if (header.serverWaiting.load() != 0) {
+        futexWake(header.sequence);
+    }
+}
+
+Peer ShmTransport::localPeer() const {
+    return local_;
+}
+
+void ShmTransport::print(std::ostream& os) const {
+    os << "ShmTransport(" << local_ << ", rings=" << outgoing_.size() + incoming_.size() << ")";
+}
+
+ShmTransport::Outgoing& ShmTransport::outgoing(const Peer& server) {
+    auto it = outgoing_.find(server);
+    if (it != end(outgoing_)) {
+        return *it->second;
+    }
+
+    if (local_.id() >= maxClients_) {
+        throw eckit::UserError("Rank " + std::to_string(local_.id()) + " exceeds max-clients (" +
+                                   std::to_string(maxClients_) + ")",
+                               Here());
+    }
+
+    std::unique_ptr<Outgoing> out{
+        new Outgoing{controlName(server.id()), headerSize + maxClients_ * sizeof(uint32_t),
+                     ringName(server.id(), local_.id()), ringSize_, openTimeout_}};
+
+    auto& header = out->header();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(openTimeout_);
+    while (header.ready.load(std::memory_order_acquire) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw eckit::SeriousBug("Server " + std::to_string(server.id()) +
+                                        " did not initialise its shared memory within " +
+                                        std::to_string(openTimeout_) + " seconds",
+                                    Here());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // The ring exists before the server can find it
+    auto slot = header.announced.fetch_add(1);
+    ASSERT(slot < maxClients_);
+    auto slots = reinterpret_cast<std::atomic<uint32_t>*>(out->control.data() + headerSize);
+    slots[slot].store(static_cast<uint32_t>(local_.id() + 1));
+
+    LOG_DEBUG_LIB(LibMultio) << "Created shared memory ring to " << server << std::endl;
+
+    return *outgoing_.emplace(server, std::move(out)).first->second;
+}
+
+SharedMemory& ShmTransport::control() {
+    if (not control_) {
+        const auto size = headerSize + maxClients_ * sizeof(uint32_t);
+        control_.reset(
+            new SharedMemory{controlName(local_.id()), size, SharedMemory::Mode::Create});
+
+        // Clients wait for ready before touching the segment
+        auto& header = *reinterpret_cast<ControlHeader*>(control_->data());
+        header.sequence.store(0);
+        header.serverWaiting.store(0);
+        header.announced.store(0);
+        std::memset(control_->data() + headerSize, 0, maxClients_ * sizeof(uint32_t));
+        header.ready.store(1, std::memory_order_release);
+    }
+    return *control_;
+}
+
+void ShmTransport::openIncoming() {
+    auto& header = *reinterpret_cast<ControlHeader*>(control().data());
+    auto slots = reinterpret_cast<std::atomic<uint32_t>*>(control().data() + headerSize);
+
+    const auto announced = header.announced.load();
+    while (incoming_.size() < announced) {
+        // A client may have claimed the slot but not yet written its rank
+        const auto client = slots[incoming_.size()].load();
+        if (client == 0) {
+            return;
+        }
+
+        incoming_.emplace_back(
+            new ShmRing{ringName(local_.id(), client - 1), ringSize_, SharedMemory::Mode::Open});
+
+        LOG_DEBUG_LIB(LibMultio) << "Opened shared memory ring from client " << client - 1
+                                 << std::endl;
+    }
+}
+
+bool ShmTransport::nextMessage(Message& msg) {
+    openIncoming();
+
+    // Take turns between clients so that none of them is starved
+    for (size_t i = 0; i != incoming_.size(); ++i) {
+        auto& ring = *incoming_[nextIncoming_];
+        nextIncoming_ = (nextIncoming_ + 1) % incoming_.size();
+
+        const char* data = nullptr;
+        size_t bytes = 0;
+        if (ring.peek(data, bytes)) {
+            eckit::MemoryStream stream{data, bytes};
+            msg = decodeMessage(stream);
+            ring.pop(bytes);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string ShmTransport::controlName(size_t server) const {
+    return prefix_ + "-" + std::to_string(server);
+}
+
+std::string ShmTransport::ringName(size_t server, size_t client) const {
+    return prefix_ + "-" + std::to_string(server) + "-" + std::to_string(client);
+}
+
+static TransportBuilder<ShmTransport> ShmTransportBuilder("shm");
+
+}  // namespace server
+}  // namespace multio
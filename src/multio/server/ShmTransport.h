@@ -0,0 +1,90 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_server_ShmTransport_H
+#define multio_server_ShmTransport_H
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "multio/server/Transport.h"
+
+namespace multio {
+namespace server {
+
+class ShmPeer : public Peer {
+public:
+    ShmPeer(const std::string& group, size_t rank);
+};
+
+class SharedMemory;
+class ShmRing;
+
+/// Transport for clients and servers on the same node. Every (server, client) pair has a ring
+/// buffer in POSIX shared memory. A client encodes each message straight into the ring and the
+/// server decodes it from there, so no intermediate buffer or MPI call is involved. A server
+/// sleeps on a futex in its own shared control segment, which clients ring after each message.
+///
+/// Ranks are taken from the MPI communicator named by "group", as for the MPI transport, and
+/// the servers are the ranks following the clients. Construction is collective over the group:
+/// rank 0 broadcasts a token that makes the segment names unique to this run of the job.
+///
+/// A server creates its control segment on its first receive, replacing any leftover segment of
+/// the same name, and removes its segments when it shuts down. Each client creates its own rings
+/// and waits up to "open-timeout" seconds for the control segment of a server to appear.
+
+class ShmTransport final : public Transport {
+public:
+    ShmTransport(const eckit::Configuration& config);
+    ~ShmTransport() override;
+
+private:
+    Message receive() override;
+
+    void send(const Message& message) override;
+
+    Peer localPeer() const override;
+
+    void print(std::ostream& os) const override;
+
+    struct Outgoing;
+
+    Outgoing& outgoing(const Peer& server);
+
+    SharedMemory& control();
+    void openIncoming();
+    bool nextMessage(Message& msg);
+
+    std::string controlName(size_t server) const;
+    std::string ringName(size_t server, size_t client) const;
+
+    ShmPeer local_;
+
+    const std::string prefix_;
+    const size_t ringSize_;
+    const size_t maxClients_;
+    const unsigned openTimeout_;
+
+    std::map<Peer, std::unique_ptr<Outgoing>> outgoing_;
+
+    // Server side, set up by the first call to receive
+    std::unique_ptr<SharedMemory> control_;
+    std::vector<std::unique_ptr<ShmRing>> incoming_;
+    size_t nextIncoming_ = 0;
+};
+
+}  // namespace server
+}  // namespace multio
+
+#endif
@@ -6,6 +6,7 @@
 #include "eckit/exception/Exceptions.h"
 #include "eckit/mpi/Comm.h"
 #include "multio/util/ScopedTimer.h"
+#include "multio/util/Trace.h"
 
 
 namespace multio {
@@ -51,6 +52,8 @@ MpiStream& StreamPool::getStream(const message::Message& msg) {
     strm.buffer().request = comm_.iSend<void>(strm.buffer().content, sz, destId, msg_tag);
     strm.buffer().status = BufferStatus::transmitting;
 
+    MULTIO_TRACE(util::TraceLevel::Info, "mpi-isend", dest.id(), sz);
+
     bytesSent_ += sz;
 
     return replaceStream(dest);
@@ -69,17 +72,21 @@ void StreamPool::send(const message::Message& msg) {
     auto destId = static_cast<int>(msg.destination().id());
     comm_.send<void>(strm.buffer().content, sz, destId, static_cast<int>(msg.tag()));
     bytesSent_ += sz;
+
+    MULTIO_TRACE(util::TraceLevel::Info, "mpi-send", msg.destination().id(), sz);
 }
 
 MpiBuffer& StreamPool::findAvailableBuffer() {
     auto it = std::end(buffers_);
+    size_t scans = 0;
     while (it == std::end(buffers_)) {
         it = std::find_if(std::begin(buffers_), std::end(buffers_),
                           [](MpiBuffer& buf) { return buf.isFree(); });
+        ++scans;
     }
 
-    eckit::Log::info() << " *** -- Found available buffer with idx = "
-                       << static_cast<size_t>(std::distance(std::begin(buffers_), it)) << std::endl;
+    MULTIO_TRACE(util::TraceLevel::Debug, "mpi-buffer-acquired",
+                 static_cast<size_t>(std::distance(std::begin(buffers_), it)), scans);
 
     return *it;
 }
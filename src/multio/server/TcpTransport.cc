@@ -10,20 +10,89 @@
 
 #include "TcpTransport.h"
 
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <iostream>
 
 #include "eckit/config/LocalConfiguration.h"
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
 #include "eckit/log/Plural.h"
 #include "eckit/maths/Functions.h"
 #include "eckit/runtime/Main.h"
 #include "eckit/serialisation/MemoryStream.h"
 
+#include "multio/LibMultio.h"
+
 namespace multio {
 namespace server {
 
 namespace {
-Message decodeMessage(eckit::Stream& stream) {
+
+// A frame is its length followed by records. Each record is the length of the encoded header,
+// the length of the payload, the header and the payload.
+const size_t recordPrefixSize = 2 * sizeof(uint64_t);
+
+// Add 4K for header/footer etc. Should be plenty
+const size_t maxHeaderSize = 4096;
+
+// First bytes on every connection, in both directions. The server sets accepted to 1 if it
+// speaks the same protocol version. On the wire, each field is big-endian and there is no
+// padding, so the layout does not depend on the host.
+struct Handshake {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t accepted;
+
+    static const size_t size = 16;
+
+    void encode(unsigned char* out) const {
+        putBigEndian(out, magic, 8);
+        putBigEndian(out + 8, version, 4);
+        putBigEndian(out + 12, accepted, 4);
+    }
+
+    static Handshake decode(const unsigned char* in) {
+        return Handshake{getBigEndian(in, 8), static_cast<uint32_t>(getBigEndian(in + 8, 4)),
+                         static_cast<uint32_t>(getBigEndian(in + 12, 4))};
+    }
+
+private:
+    static void putBigEndian(unsigned char* out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i != bytes; ++i) {
+            out[i] = static_cast<unsigned char>(value >> (8 * (bytes - 1 - i)));
+        }
+    }
+
+    static uint64_t getBigEndian(const unsigned char* in, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i != bytes; ++i) {
+            value = (value << 8) | in[i];
+        }
+        return value;
+    }
+};
+
+const uint64_t handshakeMagic = 0x4d554c54494f0000;  // "MULTIO"
+const uint32_t protocolVersion = 2;
+
+Message::Header decodeHeader(eckit::Stream& stream) {
     unsigned t;
     stream >> t;
 
@@ -40,16 +109,110 @@ Message decodeMessage(eckit::Stream& stream) {
     std::string fieldId;
     stream >> fieldId;
 
-    unsigned long sz;
-    stream >> sz;
+    return Message::Header{static_cast<Message::Tag>(t), TcpPeer{src_grp, src_id},
+                           TcpPeer{dest_grp, dest_id}, std::move(fieldId)};
+}
 
-    eckit::Buffer buffer(sz);
-    stream >> buffer;
+void writeAll(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        auto written = ::writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw eckit::FailedSystemCall("writev", Here(), errno);
+        }
 
-    return Message{Message::Header{static_cast<Message::Tag>(t), TcpPeer{src_grp, src_id},
-                                TcpPeer{dest_grp, dest_id}, std::move(fieldId)},
-                std::move(buffer)};
+        while (count > 0 && static_cast<size_t>(written) >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
 }
+
+void readAll(int fd, void* data, size_t size) {
+    auto p = static_cast<char*>(data);
+    while (size > 0) {
+        auto bytes = ::read(fd, p, size);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            throw eckit::FailedSystemCall("read", Here(), bytes < 0 ? errno : ECONNRESET);
+        }
+        p += bytes;
+        size -= static_cast<size_t>(bytes);
+    }
+}
+
+void setBlocking(int fd, bool blocking) {
+    auto flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 ||
+        ::fcntl(fd, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) < 0) {
+        throw eckit::FailedSystemCall("fcntl", Here(), errno);
+    }
+}
+
+// Returns a connected socket, or -1 if the server does not accept connections (yet)
+int connectTo(const std::string& host, size_t port, int timeoutMilliseconds) {
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    try {
+        for (auto address = addresses; address != nullptr && fd < 0; address = address->ai_next) {
+            fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+
+            // Connect without blocking, so that an unreachable host does not hold up the others
+            setBlocking(fd, false);
+            int error = 0;
+            if (::connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+                error = errno;
+                if (error == EINPROGRESS) {
+                    struct pollfd pfd = {fd, POLLOUT, 0};
+                    socklen_t length = sizeof(error);
+                    if (::poll(&pfd, 1, timeoutMilliseconds) != 1 ||
+                        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0) {
+                        error = ETIMEDOUT;
+                    }
+                }
+            }
+
+            if (error != 0) {
+                ::close(fd);
+                fd = -1;
+                continue;
+            }
+            setBlocking(fd, true);
+        }
+    }
+    catch (...) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        ::freeaddrinfo(addresses);
+        throw;
+    }
+
+    ::freeaddrinfo(addresses);
+    return fd;
+}
+
 }  // namespace
 
 
@@ -65,26 +228,67 @@ size_t TcpPeer::port() const {
 }
 
 struct Connection {
-    eckit::Select& select_;
     eckit::net::TCPSocket socket_;
 
-    Connection(eckit::Select& select, eckit::net::TCPSocket& socket) :
-        select_{select},
-        socket_{socket} {
-        select_.add(socket_);
+    // Bytes read but not yet decoded, starting at a frame boundary
+    eckit::Buffer buffer_;
+    size_t filled_ = 0;
+
+    bool handshaken_ = false;
+
+    Connection(eckit::net::TCPSocket& socket) : socket_{socket}, buffer_{64 * 1024} {
+        setBlocking(fd(), false);
     }
 
-    ~Connection() {
-        select_.remove(socket_);
-        socket_.close();
+    ~Connection() { socket_.close(); }
+
+    int fd() const { return socket_.socket(); }
+};
+
+struct Outgoing {
+    const std::string host;
+    const size_t port;
+
+    // Set by the connecting thread. Once connected is true, only the sending thread uses fd.
+    int fd = -1;
+    std::atomic<bool> connected{false};
+    std::string error;
+
+    // Frames sent before the connection was established, guarded by the transport's mutex
+    std::deque<eckit::Buffer> pending;
+
+    eckit::Buffer batch;
+    size_t used = sizeof(uint64_t);  // Leaves room for the frame length
+
+    Outgoing(const std::string& h, size_t p, size_t bufferSize) :
+        host{h}, port{p}, batch{bufferSize} {}
+
+    ~Outgoing() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
     }
 
-    bool ready() { return select_.set(socket_); }
+    bool empty() const { return used == sizeof(uint64_t); }
+    bool failed() const { return not error.empty(); }
 };
 
 TcpTransport::TcpTransport(const eckit::Configuration& config) :
     Transport(config),
-    local_{"localhost", config.getUnsigned("local_port")} {
+    local_{"localhost", config.getUnsigned("local_port")},
+    bufferSize_{std::max<size_t>(
+        config.getUnsigned("buffer-size", eckit::Resource<size_t>(
+                                              "multioTcpBufferSize;$MULTIO_TCP_BUFFER_SIZE",
+                                              4 * 1024 * 1024)),
+        2 * (recordPrefixSize + maxHeaderSize))},
+    copyThreshold_{std::min<size_t>(config.getUnsigned("copy-threshold", 64 * 1024),
+                                    bufferSize_ - sizeof(uint64_t) - recordPrefixSize -
+                                        maxHeaderSize)},
+    noDelay_{config.getBool("tcp-nodelay", true)},
+    connectTimeout_{config.getUnsigned("connect-timeout", 300)},
+    closeTimeout_{config.getUnsigned("close-timeout", 10)},
+    pendingBudget_{config.getUnsigned("connect-buffer-size", 256 * 1024 * 1024)},
+    received_{eckit::Resource<size_t>("multioMessageQueueSize;$MULTIO_MESSAGE_QUEUE_SIZE", 1024)} {
     auto serverConfigs = config.getSubConfigurations("servers");
 
     for (auto cfg : serverConfigs) {
@@ -94,76 +298,316 @@ TcpTransport::TcpTransport(const eckit::Configuration& config) :
         if (amIServer(host, ports)) {
             server_.reset(new eckit::net::TCPServer{static_cast<int>(local_.port()),
                                                     eckit::net::SocketOptions::server()});
-            select_.add(*server_);
         }
         else {
             // TODO: assert that (local_.host(), local_.port()) is in the list of clients
             for (const auto port : ports) {
-                try {
-                    eckit::net::TCPClient client;
-                    std::unique_ptr<eckit::net::TCPSocket> socket{
-                        new eckit::net::TCPSocket{client.connect(host, port, 5, 10)}};
-                    outgoing_.emplace(TcpPeer{host, port}, std::move(socket));
-                }
-                catch (eckit::TooManyRetries& e) {
-                    eckit::Log::error() << "Failed to establish connection to host: " << host
-                                        << ", port: " << port << std::endl;
-                }
+                outgoing_.emplace(TcpPeer{host, port}, std::unique_ptr<Outgoing>{
+                                                           new Outgoing{host, port, bufferSize_}});
             }
         }
     }
+
+    if (server_) {
+        startListening();
+    }
+
+    // Servers may come up after their clients: connect in the background and keep what is
+    // sent in the meantime
+    if (not outgoing_.empty()) {
+        connector_ = std::thread{&TcpTransport::connectAll, this};
+    }
 }
 
 
-Message TcpTransport::nextMessage(eckit::net::TCPSocket& socket) const {
-    size_t size;
-    socket.read(&size, sizeof(size));
+TcpTransport::~TcpTransport() {
+    for (auto& out : outgoing_) {
+        try {
+            flush(*out.second);
+        }
+        catch (const std::exception& e) {
+            eckit::Log::error() << "Failed to send to " << out.first << ": " << e.what()
+                                << std::endl;
+        }
+    }
 
-    eckit::Buffer buffer{size};
-    socket.read(buffer, static_cast<long>(size));
+    // Frames still pending get "close-timeout" seconds to reach their servers; without any, the
+    // connecting thread stops at once
+    if (connector_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopDeadline_ = std::chrono::steady_clock::now() +
+                            std::chrono::seconds(pendingBytes_ > 0 ? closeTimeout_ : 0);
+            stopping_ = true;
+        }
+        stopRequested_.notify_all();
+        connector_.join();
+    }
 
-    eckit::MemoryStream stream{buffer};
+    if (listener_.joinable()) {
+        uint64_t one = 1;
+        if (::write(wakeupFd_, &one, sizeof(one)) < 0) {
+            eckit::Log::error() << "Failed to stop the receiving thread of " << *this << std::endl;
+        }
+        listener_.join();
+        ::close(wakeupFd_);
+        ::close(epollFd_);
+    }
+}
 
-    return decodeMessage(stream);
+void TcpTransport::decodeFrame(const char* frame, size_t size) {
+    const char* record = frame;
+    const char* end = record + size;
+    while (record < end) {
+        uint64_t headerSize;
+        uint64_t payloadSize;
+        std::memcpy(&headerSize, record, sizeof(headerSize));
+        std::memcpy(&payloadSize, record + sizeof(headerSize), sizeof(payloadSize));
+        record += recordPrefixSize;
+
+        eckit::MemoryStream stream{record, headerSize};
+        auto header = decodeHeader(stream);
+        record += headerSize;
+
+        received_.push(Message{std::move(header), eckit::Buffer{record, payloadSize}});
+        record += payloadSize;
+    }
 }
 
 Message TcpTransport::receive() {
+    Message msg;
+    if (received_.pop(msg) < 0) {
+        throw eckit::SeriousBug("No message received", Here());
+    }
+    return msg;
+}
 
-    waitForEvent();
+void TcpTransport::send(const Message& msg) {
+    auto& out = *outgoing_.at(msg.destination());
 
-    for (auto it = begin(incoming_); it != end(incoming_); ++it) {
-        if (not (*it)->ready()) {
-            continue;
+    const auto payloadSize = msg.size();
+    const bool copy = payloadSize < copyThreshold_;
+
+    if (out.used + recordPrefixSize + maxHeaderSize + (copy ? payloadSize : 0) >
+        out.batch.size()) {
+        flush(out);
+    }
+
+    char* record = static_cast<char*>(out.batch.data()) + out.used;
+
+    eckit::MemoryStream stream{record + recordPrefixSize, maxHeaderSize};
+    msg.header().encode(stream);
+
+    const uint64_t headerSize = static_cast<uint64_t>(stream.bytesWritten());
+    const uint64_t payloadBytes = payloadSize;
+    std::memcpy(record, &headerSize, sizeof(headerSize));
+    std::memcpy(record + sizeof(headerSize), &payloadBytes, sizeof(payloadBytes));
+    out.used += recordPrefixSize + headerSize;
+
+    if (not copy) {
+        flush(out, &msg.payload());
+        return;
+    }
+
+    std::memcpy(static_cast<char*>(out.batch.data()) + out.used, msg.payload().data(),
+                payloadSize);
+    out.used += payloadSize;
+
+    if (msg.tag() == Message::Tag::Close || msg.tag() == Message::Tag::StepComplete) {
+        flush(out);
+    }
+}
+
+void TcpTransport::flush(Outgoing& out, const eckit::Buffer* payload) {
+    if (out.empty()) {
+        return;
+    }
+
+    const size_t payloadSize = payload ? payload->size() : 0;
+
+    const uint64_t frameSize = out.used - sizeof(uint64_t) + payloadSize;
+    std::memcpy(out.batch.data(), &frameSize, sizeof(frameSize));
+
+    if (out.connected.load(std::memory_order_acquire) || not queueFrame(out, payload)) {
+        struct iovec iov[2];
+        iov[0].iov_base = out.batch.data();
+        iov[0].iov_len = out.used;
+        iov[1].iov_base = const_cast<void*>(payload ? payload->data() : nullptr);
+        iov[1].iov_len = payloadSize;
+
+        writeAll(out.fd, iov, payloadSize > 0 ? 2 : 1);
+    }
+
+    out.used = sizeof(uint64_t);
+}
+
+bool TcpTransport::queueFrame(Outgoing& out, const eckit::Buffer* payload) {
+    const size_t payloadSize = payload ? payload->size() : 0;
+    const size_t size = out.used + payloadSize;
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    connectionChanged_.wait(lock, [this, &out, size]() {
+        return out.connected || out.failed() || pendingBytes_ + size <= pendingBudget_ ||
+               pendingBytes_ == 0;
+    });
+
+    if (out.failed()) {
+        throw eckit::SeriousBug("Cannot send to " + out.host + ":" + std::to_string(out.port) +
+                                    ": " + out.error,
+                                Here());
+    }
+    if (out.connected) {
+        return false;
+    }
+
+    eckit::Buffer frame{size};
+    std::memcpy(frame.data(), out.batch.data(), out.used);
+    if (payloadSize > 0) {
+        std::memcpy(static_cast<char*>(frame.data()) + out.used, payload->data(), payloadSize);
+    }
+    out.pending.push_back(std::move(frame));
+    pendingBytes_ += size;
+
+    return true;
+}
+
+void TcpTransport::connectAll() {
+    using Clock = std::chrono::steady_clock;
+
+    const auto deadline = Clock::now() + std::chrono::seconds(connectTimeout_);
+    auto backoff = std::chrono::milliseconds(100);
+
+    // Call with mutex_ held
+    auto giveUp = [this](const std::string& reason) {
+        for (auto& out : outgoing_) {
+            if (not out.second->connected && not out.second->failed()) {
+                fail(*out.second, reason);
+            }
+        }
+    };
+
+    while (true) {
+        size_t waiting = 0;
+        for (auto& out : outgoing_) {
+            if (not out.second->connected && not out.second->failed()) {
+                // Nothing may escape this thread; the next send or flush to the server rethrows
+                try {
+                    waiting += connect(*out.second) ? 0 : 1;
+                }
+                catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    fail(*out.second, e.what());
+                }
+            }
         }
 
-        auto msg = nextMessage((*it)->socket_);
+        if (waiting == 0) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        const auto now = Clock::now();
+
+        if (stopping_ && (pendingBytes_ == 0 || now >= stopDeadline_)) {
+            giveUp("transport shut down before connecting");
+            return;
+        }
+        if (now + backoff > deadline) {
+            giveUp("no connection after " + std::to_string(connectTimeout_) + " seconds");
+            return;
+        }
 
-        if(msg.tag() == Message::Tag::Close) {
-            incoming_.erase(it);
-        } else {
-            std::swap(*it, incoming_[incoming_.size() - 1]);
+        // The destructor interrupts the wait
+        auto wakeAt = now + backoff;
+        if (stopping_) {
+            wakeAt = std::min(wakeAt, stopDeadline_);
         }
+        const bool wasStopping = stopping_;
+        stopRequested_.wait_until(lock, wakeAt,
+                                  [this, wasStopping]() { return stopping_ != wasStopping; });
 
-        return msg;
+        backoff = std::min(2 * backoff, std::chrono::milliseconds(10000));
+    }
+}
+
+void TcpTransport::fail(Outgoing& out, const std::string& reason) {
+    out.error = reason;
+    eckit::Log::error() << "Failed to establish connection to host: " << out.host
+                        << ", port: " << out.port << " (" << reason << ")" << std::endl;
+
+    if (not out.pending.empty()) {
+        eckit::Log::error() << "Dropping " << out.pending.size() << " frames for " << out.host
+                            << ":" << out.port << std::endl;
+    }
+    for (auto& frame : out.pending) {
+        pendingBytes_ -= frame.size();
     }
+    out.pending.clear();
 
-    throw eckit::SeriousBug("No message received");
+    connectionChanged_.notify_all();
 }
 
-void TcpTransport::send(const Message& msg) {
-    const auto& socket = outgoing_.at(msg.destination());
+bool TcpTransport::connect(Outgoing& out) {
+    int fd = connectTo(out.host, out.port, 5000);
+    if (fd < 0) {
+        return false;
+    }
 
-    // Add 4K for header/footer etc. Should be plenty
-    eckit::Buffer buffer{eckit::round(msg.size(), 8) + 4096};
+    // Frames are written whole, so there is nothing for Nagle to coalesce
+    int flag = noDelay_ ? 1 : 0;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    std::string error;
+    try {
+        unsigned char bytes[Handshake::size];
+        Handshake{handshakeMagic, protocolVersion, 0}.encode(bytes);
+        struct iovec iov = {bytes, sizeof(bytes)};
+        writeAll(fd, &iov, 1);
+
+        readAll(fd, bytes, sizeof(bytes));
+        auto reply = Handshake::decode(bytes);
+        if (reply.magic != handshakeMagic || reply.accepted != 1) {
+            error = "server speaks protocol version " + std::to_string(reply.version) +
+                    ", expected " + std::to_string(protocolVersion);
+        }
+    }
+    catch (const eckit::FailedSystemCall&) {
+        // The server went away during the handshake: try again later
+        ::close(fd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    if (not error.empty()) {
+        ::close(fd);
+        fail(out, "rejected: " + error);
+        return true;
+    }
 
-    eckit::MemoryStream stream{buffer};
+    try {
+        while (not out.pending.empty()) {
+            auto& frame = out.pending.front();
+            struct iovec iov = {frame.data(), frame.size()};
+            writeAll(fd, &iov, 1);
+            pendingBytes_ -= frame.size();
+            out.pending.pop_front();
+        }
+    }
+    catch (const eckit::FailedSystemCall& e) {
+        // The server went away after the handshake, with frames of this client only partly sent
+        ::close(fd);
+        fail(out, std::string{"connection lost while sending queued frames: "} + e.what());
+        return true;
+    }
 
-    msg.encode(stream);
+    out.fd = fd;
+    out.connected.store(true, std::memory_order_release);
+    connectionChanged_.notify_all();
 
-    auto size = stream.bytesWritten();
-    socket->write(&size, sizeof(size));
+    LOG_DEBUG_LIB(LibMultio) << "Connected to " << out.host << ":" << out.port << std::endl;
 
-    socket->write(buffer, static_cast<int>(size));
+    return true;
 }
 
 Peer TcpTransport::localPeer() const {
@@ -174,25 +618,166 @@ void TcpTransport::print(std::ostream& os) const {
     os << "TcpTransport()";
 }
 
-bool TcpTransport::acceptConnection() {
-    if (not select_.set(*server_)) {
-        return false;
+void TcpTransport::startListening() {
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        throw eckit::FailedSystemCall("epoll_create1", Here(), errno);
+    }
+
+    wakeupFd_ = ::eventfd(0, EFD_CLOEXEC);
+    if (wakeupFd_ < 0) {
+        throw eckit::FailedSystemCall("eventfd", Here(), errno);
+    }
+
+    watch(server_->socket());
+    watch(wakeupFd_);
+
+    listener_ = std::thread{&TcpTransport::listen, this};
+}
+
+void TcpTransport::watch(int fd) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw eckit::FailedSystemCall("epoll_ctl", Here(), errno);
     }
+}
 
+void TcpTransport::listen() {
+    try {
+        struct epoll_event events[64];
+        while (true) {
+            auto count = ::epoll_wait(epollFd_, events, 64, 5000);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw eckit::FailedSystemCall("epoll_wait", Here(), errno);
+            }
+
+            if (count == 0) {
+                eckit::Log::info() << "Waiting... There are "
+                                   << eckit::Plural(incoming_.size(), "connection")
+                                   << " still active" << std::endl;
+                continue;
+            }
+
+            for (int i = 0; i != count; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wakeupFd_) {
+                    return;
+                }
+
+                if (fd == server_->socket()) {
+                    acceptConnection();
+                }
+                else {
+                    readConnection(fd);
+                }
+            }
+        }
+    }
+    catch (...) {
+        received_.interrupt(std::current_exception());
+    }
+}
+
+void TcpTransport::acceptConnection() {
     eckit::net::TCPSocket socket{server_->accept()};
-    incoming_.emplace_back(new Connection{select_, socket});
 
-    return true;
+    std::unique_ptr<Connection> conn{new Connection{socket}};
+    watch(conn->fd());
+    incoming_.emplace(conn->fd(), std::move(conn));
+}
+
+void TcpTransport::readConnection(int fd) {
+    auto& conn = *incoming_.at(fd);
+
+    // Read until the socket has nothing more to give, decoding complete frames as they arrive
+    while (true) {
+        auto bytes = ::read(fd, static_cast<char*>(conn.buffer_.data()) + conn.filled_,
+                            conn.buffer_.size() - conn.filled_);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            throw eckit::FailedSystemCall("read", Here(), errno);
+        }
+
+        if (bytes == 0) {
+            if (conn.filled_ > 0) {
+                eckit::Log::warning() << "Connection closed with " << conn.filled_
+                                      << " bytes of an incomplete frame" << std::endl;
+            }
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+            incoming_.erase(fd);
+            return;
+        }
+
+        conn.filled_ += static_cast<size_t>(bytes);
+        if (not decodeFrames(conn)) {
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+            incoming_.erase(fd);
+            return;
+        }
+    }
 }
 
-void TcpTransport::waitForEvent() {
-    do {
-        while (not select_.ready(5)) {
-            eckit::Log::info() << "Waiting... There are "
-                               << eckit::Plural(incoming_.size(), "connection") << " still active"
-                               << std::endl;
+bool TcpTransport::decodeFrames(Connection& conn) {
+    const char* data = conn.buffer_;
+
+    size_t offset = 0;
+    if (not conn.handshaken_) {
+        if (conn.filled_ < Handshake::size) {
+            return true;
+        }
+
+        auto hello = Handshake::decode(reinterpret_cast<const unsigned char*>(data));
+
+        const bool accepted = hello.magic == handshakeMagic && hello.version == protocolVersion;
+        unsigned char reply[Handshake::size];
+        Handshake{handshakeMagic, protocolVersion, accepted ? 1u : 0u}.encode(reply);
+        if (::write(conn.fd(), reply, sizeof(reply)) != sizeof(reply) || not accepted) {
+            eckit::Log::error() << "Rejecting connection: handshake for protocol version "
+                                << hello.version << ", expected " << protocolVersion << std::endl;
+            return false;
         }
-    } while (acceptConnection());
+
+        conn.handshaken_ = true;
+        offset = Handshake::size;
+    }
+
+    while (conn.filled_ - offset >= sizeof(uint64_t)) {
+        uint64_t frameSize;
+        std::memcpy(&frameSize, data + offset, sizeof(frameSize));
+
+        const size_t needed = sizeof(uint64_t) + frameSize;
+        if (conn.filled_ - offset < needed) {
+            break;
+        }
+
+        decodeFrame(data + offset + sizeof(uint64_t), frameSize);
+        offset += needed;
+    }
+
+    // Keep the incomplete frame at the start of the buffer, and make room for all of it
+    std::memmove(conn.buffer_.data(), data + offset, conn.filled_ - offset);
+    conn.filled_ -= offset;
+
+    if (conn.filled_ >= sizeof(uint64_t)) {
+        uint64_t frameSize;
+        std::memcpy(&frameSize, conn.buffer_.data(), sizeof(frameSize));
+        if (sizeof(uint64_t) + frameSize > conn.buffer_.size()) {
+            conn.buffer_.resize(sizeof(uint64_t) + frameSize, true);
+        }
+    }
+
+    return true;
 }
 
 bool TcpTransport::amIServer(const std::string& host, std::vector<size_t> ports) {
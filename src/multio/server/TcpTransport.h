@@ -17,13 +17,16 @@
 #ifndef multio_server_TcpTransport_H
 #define multio_server_TcpTransport_H
 
+#include <chrono>
+#include <condition_variable>
 #include <iosfwd>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
-#include "eckit/net/TCPClient.h"
+#include "eckit/container/Queue.h"
 #include "eckit/net/TCPServer.h"
-#include "eckit/io/Select.h"
 
 #include "multio/server/Transport.h"
 
@@ -47,10 +50,25 @@ public:
 };
 
 struct Connection;
+struct Outgoing;
+
+/// Messages to a server are batched into one frame per destination, which is sent when the
+/// batch is full, on StepComplete and on Close. A payload of at least "copy-threshold" bytes is
+/// not copied: it is sent with writev right behind the frame that holds its header.
+///
+/// A server receives on a dedicated thread. It waits on epoll for all connections, reads
+/// whatever is available without blocking and decodes every complete frame into a queue.
+///
+/// Clients connect to their servers in the background, retrying with exponential backoff for up
+/// to "connect-timeout" seconds. Each connection starts with a handshake that checks the
+/// protocol version. Until a server is reached, frames for it are kept in memory, up to
+/// "connect-buffer-size" bytes over all servers. On destruction, such frames get another
+/// "close-timeout" seconds to reach their servers before they are dropped.
 
 class TcpTransport final : public Transport {
 public:
     TcpTransport(const eckit::Configuration& config);
+    ~TcpTransport() override;
 
 private:
     Message receive() override;
@@ -61,21 +79,59 @@ private:
 
     void print(std::ostream& os) const override;
 
-    Message nextMessage(eckit::net::TCPSocket& socket) const;
+    void decodeFrame(const char* frame, size_t size);
 
-    bool acceptConnection();
-    void waitForEvent();
+    void flush(Outgoing& out, const eckit::Buffer* payload = nullptr);
+    bool queueFrame(Outgoing& out, const eckit::Buffer* payload);
+
+    void connectAll();
+    bool connect(Outgoing& out);
+
+    // Records why out cannot be reached and drops its pending frames; call with mutex_ held
+    void fail(Outgoing& out, const std::string& reason);
+
+    void startListening();
+    void watch(int fd);
+    void listen();
+
+    void acceptConnection();
+    void readConnection(int fd);
+    bool decodeFrames(Connection& conn);
 
     bool amIServer(const std::string& host, std::vector<size_t> ports);
 
     TcpPeer local_;
 
-    std::map<Peer, const std::unique_ptr<eckit::net::TCPSocket>> outgoing_;
+    const size_t bufferSize_;
+    const size_t copyThreshold_;
+    const bool noDelay_;
+    const size_t connectTimeout_;
+    const size_t closeTimeout_;
+    const size_t pendingBudget_;
+
+    std::map<Peer, std::unique_ptr<Outgoing>> outgoing_;
 
-    eckit::Select select_;
+    // Client side, shared with the connecting thread
+    std::mutex mutex_;
+    std::condition_variable connectionChanged_;
+    size_t pendingBytes_ = 0;
+
+    // Set by the destructor to interrupt the backoff of the connecting thread
+    bool stopping_ = false;
+    std::chrono::steady_clock::time_point stopDeadline_;
+    std::condition_variable stopRequested_;
+
+    std::thread connector_;
 
     std::unique_ptr<eckit::net::TCPServer> server_;
-    std::vector<std::unique_ptr<Connection>> incoming_;
+
+    // Server side, owned by the receiving thread
+    std::map<int, std::unique_ptr<Connection>> incoming_;
+    int epollFd_ = -1;
+    int wakeupFd_ = -1;
+
+    eckit::Queue<Message> received_;
+    std::thread listener_;
 };
 
 }  // namespace server
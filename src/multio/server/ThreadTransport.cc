@@ -10,7 +10,14 @@
 
 #include "ThreadTransport.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
 
 #include "multio/LibMultio.h"
 
@@ -22,52 +29,260 @@ ThreadPeer::ThreadPeer(std::thread t) :
     thread_{std::move(t)} {}
 
 
+namespace {
+
+std::atomic<size_t> transportCount{0};
+
+size_t threadId() {
+    thread_local const size_t id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return id;
+}
+
+}  // namespace
+
+/// Bounded single-producer single-consumer queue. head_ is only written by the consumer and
+/// tail_ only by the producer; each keeps a copy of the other's index to avoid sharing the
+/// cache line on every call.
+class ThreadTransport::Ring {
+public:
+    Ring(size_t capacity, const Peer& client) :
+        slots_(capacity), mask_{capacity - 1}, client_{client} {
+        ASSERT(capacity > 0 && (capacity & mask_) == 0);
+    }
+
+    // The client whose messages go through this ring
+    const Peer& client() const { return client_; }
+
+    bool push(const Message& msg) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == slots_.size()) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == slots_.size()) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = msg;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Message& msg) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        // Release the payload now rather than when the slot is next overwritten
+        msg = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = Message{};
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<Message> slots_;
+    const size_t mask_;
+    const Peer client_;
+
+    // Keeps the consumer's and the producer's indices on separate cache lines
+    char padding0_[64];
+    std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    char padding1_[64];
+    std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
+
+/// The rings of one receiver. Senders register a ring under the mutex once; the receiver only
+/// takes the mutex to pick up new rings and to sleep.
+class ThreadTransport::Mailbox {
+public:
+    Mailbox(size_t capacity) : capacity_{capacity} {}
+
+    Ring& addRing(const Peer& client) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        rings_.emplace_back(new Ring{capacity_, client});
+        ringCount_.store(rings_.size(), std::memory_order_release);
+        return *rings_.back();
+    }
+
+    void push(Ring& ring, const Message& msg) {
+        while (not ring.push(msg)) {
+            std::this_thread::yield();
+        }
+
+        // Pairs with the store to waiting_ in pop: either the receiver sees this message or we
+        // see that it is going to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            waiting_.store(false, std::memory_order_relaxed);
+            wakeup_.notify_one();
+        }
+    }
+
+    // Waits until the receiver has taken every message sent so far on behalf of client, from any
+    // thread. Rings of other clients are left alone, so a busy client cannot hold this one up.
+    void drain(const Peer& client) {
+        std::vector<Ring*> rings;
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            for (const auto& ring : rings_) {
+                if (ring->client() == client) {
+                    rings.push_back(ring.get());
+                }
+            }
+        }
+        for (auto ring : rings) {
+            while (not ring->empty()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    Message pop() {
+        Message msg;
+        while (true) {
+            for (size_t spin = 0; spin != 64; ++spin) {
+                if (tryPop(msg)) {
+                    return msg;
+                }
+            }
+
+            std::unique_lock<std::mutex> lock{mutex_};
+            waiting_.store(true, std::memory_order_seq_cst);
+            if (ringCount_.load(std::memory_order_relaxed) != polled_.size()) {
+                refresh();
+            }
+            if (tryPop(msg)) {
+                waiting_.store(false, std::memory_order_relaxed);
+                return msg;
+            }
+            wakeup_.wait(lock, [this]() { return not waiting_.load(std::memory_order_relaxed); });
+        }
+    }
+
+private:
+    // Visits the rings round-robin, so that one busy sender cannot starve the others
+    bool tryPop(Message& msg) {
+        if (ringCount_.load(std::memory_order_acquire) != polled_.size()) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            refresh();
+        }
+        for (size_t i = 0; i != polled_.size(); ++i) {
+            next_ = (next_ + 1) % polled_.size();
+            if (polled_[next_]->pop(msg)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Called with mutex_ held
+    void refresh() {
+        polled_.clear();
+        for (const auto& ring : rings_) {
+            polled_.push_back(ring.get());
+        }
+    }
+
+    const size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::atomic<bool> waiting_{false};
+
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::atomic<size_t> ringCount_{0};
+
+    // Receiver's copy of rings_
+    std::vector<Ring*> polled_;
+    size_t next_ = 0;
+};
+
 ThreadTransport::ThreadTransport(const eckit::Configuration& cfg) :
     Transport(cfg),
+    id_{transportCount++},
     messageQueueSize_(
-        eckit::Resource<size_t>("multioMessageQueueSize;$MULTIO_MESSAGE_QUEUE_SIZE", 1024)) {}
+        eckit::Resource<size_t>("multioMessageQueueSize;$MULTIO_MESSAGE_QUEUE_SIZE", 1024)) {
+    // Ring capacities must be powers of two
+    size_t capacity = 1;
+    while (capacity < messageQueueSize_) {
+        capacity *= 2;
+    }
+    messageQueueSize_ = capacity;
+}
+
+ThreadTransport::~ThreadTransport() = default;
 
 Message ThreadTransport::receive() {
 
     Peer receiver = localPeer();
 
-    auto& queue = receiveQueue(receiver);
+    thread_local std::map<size_t, Mailbox*> cache;
+    auto it = cache.find(id_);
+    if (it == cache.end()) {
+        it = cache.emplace(id_, &mailbox(receiver)).first;
+    }
 
-    Message msg;
+    Message msg = it->second->pop();
 
-    ASSERT(queue.pop(msg) >= 0);
     ASSERT(msg.destination() == receiver);
 
     return msg;
 }
 
 void ThreadTransport::send(const Message& msg) {
-    receiveQueue(msg.destination()).push(msg);
+    // Resolved once per sending thread, receiver and client
+    thread_local std::map<std::tuple<size_t, size_t, Peer>, std::pair<Mailbox*, Ring*>> cache;
+
+    auto key = std::make_tuple(id_, msg.destination().id(), msg.source());
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        auto& box = mailbox(msg.destination());
+        it = cache.emplace(key, std::make_pair(&box, &box.addRing(msg.source()))).first;
+    }
+
+    // The receiver must see these after everything that other threads have sent before on
+    // behalf of the same client
+    auto tag = msg.tag();
+    if (tag == Message::Tag::Close || tag == Message::Tag::StepComplete) {
+        it->second.first->drain(msg.source());
+    }
+
+    it->second.first->push(*it->second.second, msg);
 }
 
 Peer ThreadTransport::localPeer() const {
-    return Peer{"thread", std::hash<std::thread::id>{}(std::this_thread::get_id())};
+    return Peer{"thread", threadId()};
 }
 
 void ThreadTransport::print(std::ostream& os) const {
-    os << "ThreadTransport(number of queues = " << queues_.size() << ")";
+    os << "ThreadTransport(number of mailboxes = " << mailboxes_.size() << ")";
 }
 
-eckit::Queue<Message>& ThreadTransport::receiveQueue(Peer dest) {
+ThreadTransport::Mailbox& ThreadTransport::mailbox(const Peer& dest) {
 
-    std::unique_lock<std::mutex> locker(mutex_);
+    std::lock_guard<std::mutex> locker(mutex_);
 
-    auto qitr = queues_.find(dest);
-    if (qitr != end(queues_)) {
-        return *qitr->second;
+    auto it = mailboxes_.find(dest);
+    if (it != end(mailboxes_)) {
+        return *it->second;
     }
 
-    queues_.emplace(dest, std::unique_ptr<eckit::Queue<Message>>{new eckit::Queue<Message>(messageQueueSize_)});
+    it = mailboxes_.emplace(dest, std::unique_ptr<Mailbox>{new Mailbox{messageQueueSize_}}).first;
 
-    eckit::Log::debug<LibMultio>()
-        << "ADD QUEUE for " << dest << " --- " << queues_.at(dest).get() << std::endl;
+    LOG_DEBUG_LIB(LibMultio) << "ADD MAILBOX for " << dest << " --- " << it->second.get()
+                             << std::endl;
 
-    return *queues_.at(dest);
+    return *it->second;
 }
 
 static TransportBuilder<ThreadTransport> ThreadTransportBuilder("thread");
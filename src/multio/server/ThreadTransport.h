@@ -18,11 +18,10 @@
 #define multio_server_ThreadTransport_H
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 
-#include "eckit/container/Queue.h"
-
 #include "multio/server/ScopedThread.h"
 #include "multio/server/Transport.h"
 
@@ -38,9 +37,19 @@ private:
     ScopedThread thread_;
 };
 
+/// Transport between threads of one process. Each sending thread gets its own lock-free
+/// single-producer single-consumer ring per receiving thread and client it sends for, created on
+/// first use and cached by the sending thread, so neither send nor receive takes a lock once the
+/// ring exists. A receiver polls its rings in turn and sleeps when they are all empty.
+///
+/// Messages from one sender arrive in order. Close and StepComplete messages also arrive after
+/// everything other threads sent before them on behalf of the same client, so that several
+/// threads can write for one client.
+
 class ThreadTransport final : public Transport {
 public:
     ThreadTransport(const eckit::Configuration& config);
+    ~ThreadTransport() override;
 
     Message receive() override;
 
@@ -51,9 +60,16 @@ private:
 
     Peer localPeer() const override;
 
-    eckit::Queue<Message>& receiveQueue(Peer to);
+    class Ring;
+    class Mailbox;
+
+    Mailbox& mailbox(const Peer& to);
+
+    // Distinguishes transports in the per-thread caches, even if one is built at the address
+    // of another that has gone
+    const size_t id_;
 
-    std::map<Peer, std::unique_ptr<eckit::Queue<Message>>> queues_;
+    std::map<Peer, std::unique_ptr<Mailbox>> mailboxes_;
 
     std::mutex mutex_;
 
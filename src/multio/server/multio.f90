@@ -1,8 +1,138 @@
 
 module multio
 
-    use multio_nemo, only: multio_open_connections, multio_close_connections, multio_write_step_complete, &
+    use, intrinsic :: iso_c_binding
+    use multio_nemo, only: multio_open_connections, multio_close_connections, multio_write_step_complete, multio_wait, &
          multio_init_server, multio_metadata_set_int_value, multio_metadata_set_string_value, multio_init_client, &
          multio_set_domain, multio_write_field, multio_field_is_active, multio_not_implemented
 
+    implicit none
+
+    ! Message builders: each handle carries its own metadata, so that several threads can build
+    ! and send fields at the same time
+    public multio_new_message, multio_delete_message
+    public multio_message_set_int_value, multio_message_set_real_value
+    public multio_message_set_string_value
+    public multio_message_send_field
+
+    interface
+
+        subroutine c_multio_new_message(handle) bind(c, name='multio_new_message_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(out) :: handle
+        end subroutine c_multio_new_message
+
+        subroutine c_multio_delete_message(handle) bind(c, name='multio_delete_message_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(in) :: handle
+        end subroutine c_multio_delete_message
+
+        subroutine c_multio_message_set_int_value(handle, key, val, key_len) &
+                bind(c, name='multio_message_set_int_value_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(in) :: handle
+            character(c_char), intent(in) :: key(*)
+            integer(c_int), intent(in) :: val
+            integer(c_int), intent(in), value :: key_len
+        end subroutine c_multio_message_set_int_value
+
+        subroutine c_multio_message_set_real_value(handle, key, val, key_len) &
+                bind(c, name='multio_message_set_real_value_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(in) :: handle
+            character(c_char), intent(in) :: key(*)
+            real(c_double), intent(in) :: val
+            integer(c_int), intent(in), value :: key_len
+        end subroutine c_multio_message_set_real_value
+
+        subroutine c_multio_message_set_string_value(handle, key, val, key_len, val_len) &
+                bind(c, name='multio_message_set_string_value_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(in) :: handle
+            character(c_char), intent(in) :: key(*)
+            character(c_char), intent(in) :: val(*)
+            integer(c_int), intent(in), value :: key_len
+            integer(c_int), intent(in), value :: val_len
+        end subroutine c_multio_message_set_string_value
+
+        subroutine c_multio_message_send_field(handle, data, sz, name, cat, name_len, cat_len) &
+                bind(c, name='multio_message_send_field_')
+            use, intrinsic :: iso_c_binding
+            implicit none
+            integer(c_int), intent(in) :: handle
+            real(c_double), dimension(*), intent(in) :: data
+            integer(c_int), intent(in) :: sz
+            character(c_char), intent(in) :: name(*)
+            character(c_char), intent(in) :: cat(*)
+            integer(c_int), intent(in), value :: name_len
+            integer(c_int), intent(in), value :: cat_len
+        end subroutine c_multio_message_send_field
+
+    end interface
+
+    contains
+
+        subroutine multio_new_message(handle)
+            implicit none
+            integer, intent(out) :: handle
+
+            call c_multio_new_message(handle)
+
+        end subroutine multio_new_message
+
+        subroutine multio_delete_message(handle)
+            implicit none
+            integer, intent(in) :: handle
+
+            call c_multio_delete_message(handle)
+
+        end subroutine multio_delete_message
+
+        subroutine multio_message_set_int_value(handle, key, val)
+            implicit none
+            integer, intent(in)      :: handle
+            character(*), intent(in) :: key
+            integer, intent(in)      :: val
+
+            call c_multio_message_set_int_value(handle, key, val, len_trim(key))
+
+        end subroutine multio_message_set_int_value
+
+        subroutine multio_message_set_real_value(handle, key, val)
+            implicit none
+            integer, intent(in)          :: handle
+            character(*), intent(in)     :: key
+            real(c_double), intent(in)   :: val
+
+            call c_multio_message_set_real_value(handle, key, val, len_trim(key))
+
+        end subroutine multio_message_set_real_value
+
+        subroutine multio_message_set_string_value(handle, key, val)
+            implicit none
+            integer, intent(in)      :: handle
+            character(*), intent(in) :: key
+            character(*), intent(in) :: val
+
+            call c_multio_message_set_string_value(handle, key, val, len_trim(key), len_trim(val))
+
+        end subroutine multio_message_set_string_value
+
+        subroutine multio_message_send_field(handle, data, name, category)
+            implicit none
+            integer, intent(in)                      :: handle
+            real(c_double), dimension(:), intent(in) :: data
+            character(*), intent(in)                 :: name
+            character(*), intent(in)                 :: category
+
+            call c_multio_message_send_field(handle, data, size(data), name, category, &
+                                             len_trim(name), len_trim(category))
+
+        end subroutine multio_message_send_field
+
 end module multio
@@ -6,6 +6,7 @@ module multio_nemo
 
     public multio_open_connections, multio_close_connections
     public multio_write_step_complete
+    public multio_wait
     public multio_init_server
     public multio_metadata_set_int_value
     public multio_metadata_set_string_value
@@ -43,6 +44,11 @@ module multio_nemo
             implicit none
         end subroutine multio_write_step_complete
 
+        subroutine multio_wait() bind(c)
+            use, intrinsic :: iso_c_binding
+            implicit none
+        end subroutine multio_wait
+
         subroutine multio_init_server(nemo_comm) bind(c)
             use, intrinsic :: iso_c_binding
             implicit none
@@ -0,0 +1,266 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "multio/sink/BufferedFileWriter.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Length.h"
+#include "eckit/log/Log.h"
+
+#include "multio/LibMultio.h"
+
+namespace multio {
+
+namespace {
+
+const size_t alignment = 4096;
+
+size_t round_down(size_t n) {
+    return n - n % alignment;
+}
+
+void pwritev_all(int fd, struct iovec* iov, int count, off_t offset, const eckit::PathName& path) {
+    while (count > 0) {
+        auto written = ::pwritev(fd, iov, count, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw eckit::WriteError(std::string(path) + ": " + std::strerror(errno));
+        }
+        offset += written;
+
+        // Skip over what has been written, which may end in the middle of a vector
+        while (count > 0 && static_cast<size_t>(written) >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+BufferedFileWriter::BufferedFileWriter(const eckit::PathName& path, bool append, size_t bufferSize,
+                                       bool direct, size_t preallocate) :
+    path_{path},
+    bufferSize_{std::max(alignment, round_down(bufferSize))},
+    direct_{direct},
+    stats_{"BufferedFileWriter " + std::string(path)} {
+
+    if (direct_ && append) {
+        throw eckit::UserError("FileSink: O_DIRECT cannot be combined with appending", Here());
+    }
+
+    int flags = O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC);
+    if (direct_) {
+#ifdef O_DIRECT
+        tailFd_ = ::open(path_.localPath(), flags, 0666);
+        if (tailFd_ < 0) {
+            throw eckit::CantOpenFile(std::string(path_));
+        }
+        flags = O_WRONLY | O_DIRECT;
+#else
+        throw eckit::NotImplemented("O_DIRECT is not available on this platform", Here());
+#endif
+    }
+
+    fd_ = ::open(path_.localPath(), flags, 0666);
+    if (fd_ < 0) {
+        throw eckit::CantOpenFile(std::string(path_));
+    }
+
+    if (append) {
+        offset_ = ::lseek(fd_, 0, SEEK_END);
+    }
+
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    if (preallocate > 0 && ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, offset_, preallocate) != 0) {
+        LOG_DEBUG_LIB(LibMultio) << "Cannot preallocate " << path_ << ": " << std::strerror(errno)
+                                 << std::endl;
+    }
+#endif
+
+    for (auto& buffer : buffers_) {
+        void* p = nullptr;
+        if (::posix_memalign(&p, alignment, bufferSize_) != 0) {
+            throw eckit::SeriousBug("Cannot allocate aligned buffer for " + std::string(path_),
+                                    Here());
+        }
+        buffer = static_cast<char*>(p);
+    }
+
+    thread_ = std::thread{&BufferedFileWriter::run, this};
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+    try {
+        flush();
+    }
+    catch (const std::exception& e) {
+        eckit::Log::error() << "Failed to write " << path_ << ": " << e.what() << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    ::close(fd_);
+    if (tailFd_ >= 0) {
+        ::close(tailFd_);
+    }
+
+    for (auto buffer : buffers_) {
+        std::free(buffer);
+    }
+}
+
+void BufferedFileWriter::write(const void* data, size_t length) {
+    auto bytes = static_cast<const char*>(data);
+
+    if (not direct_ && length >= bufferSize_) {
+        // Write the buffered data and the message with a single call, without copying
+        waitIdle();
+
+        struct iovec iov[2] = {{buffers_[current_], fill_}, {const_cast<char*>(bytes), length}};
+        timer_.start();
+        pwritev_all(fd_, iov, 2, offset_, path_);
+        timer_.stop();
+        stats_.logWrite(eckit::Length(fill_ + length), timer_);
+
+        offset_ += fill_ + length;
+        fill_ = 0;
+        return;
+    }
+
+    while (length > 0) {
+        auto n = std::min(length, bufferSize_ - fill_);
+        std::memcpy(buffers_[current_] + fill_, bytes, n);
+        fill_ += n;
+        bytes += n;
+        length -= n;
+
+        if (fill_ == bufferSize_) {
+            submit();
+        }
+    }
+}
+
+void BufferedFileWriter::flush() {
+    waitIdle();
+
+    timer_.start();
+
+    auto aligned = direct_ ? round_down(fill_) : fill_;
+    if (aligned > 0) {
+        writeOut(fd_, buffers_[current_], aligned, offset_);
+    }
+
+    auto tail = fill_ - aligned;
+    if (tail > 0) {
+        writeOut(tailFd_, buffers_[current_] + aligned, tail, offset_ + aligned);
+        std::memmove(buffers_[current_], buffers_[current_] + aligned, tail);
+    }
+
+    offset_ += aligned;
+    fill_ = tail;
+
+    timer_.stop();
+    stats_.logFlush(timer_);
+}
+
+void BufferedFileWriter::report(std::ostream& s) const {
+    stats_.report(s);
+}
+
+void BufferedFileWriter::submit() {
+    waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        pending_ = buffers_[current_];
+        pendingLength_ = fill_;
+        pendingOffset_ = offset_;
+    }
+    cv_.notify_all();
+
+    offset_ += fill_;
+    fill_ = 0;
+    current_ = 1 - current_;
+}
+
+void BufferedFileWriter::waitIdle() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    cv_.wait(lock, [this]() { return pending_ == nullptr; });
+
+    if (error_) {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void BufferedFileWriter::writeOut(int fd, const char* data, size_t length, off_t offset) {
+    struct iovec iov = {const_cast<char*>(data), length};
+    pwritev_all(fd, &iov, 1, offset, path_);
+}
+
+void BufferedFileWriter::run() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || pending_ != nullptr; });
+        if (pending_ == nullptr) {
+            return;
+        }
+
+        // The buffer being written is not touched by the caller until pending_ is reset
+        lock.unlock();
+        try {
+            timer_.start();
+            writeOut(fd_, pending_, pendingLength_, pendingOffset_);
+            timer_.stop();
+            stats_.logWrite(eckit::Length(pendingLength_), timer_);
+        }
+        catch (...) {
+            lock.lock();
+            error_ = std::current_exception();
+            lock.unlock();
+        }
+        lock.lock();
+
+        pending_ = nullptr;
+        cv_.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace multio
@@ -0,0 +1,96 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_BufferedFileWriter_H
+#define multio_BufferedFileWriter_H
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <exception>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Timer.h"
+#include "eckit/memory/NonCopyable.h"
+
+#include "multio/sink/IOStats.h"
+
+namespace multio {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Coalesces writes into two aligned buffers. While one buffer is filled, a background thread
+/// writes the other with pwrite. Messages larger than a buffer go out with pwritev together
+/// with whatever is buffered.
+///
+/// With O_DIRECT, only whole aligned blocks go through the direct descriptor. On flush the
+/// unaligned tail is written through a second, buffered descriptor and kept, so that it is
+/// written again as part of the next aligned block.
+
+class BufferedFileWriter : private eckit::NonCopyable {
+public:  // methods
+    BufferedFileWriter(const eckit::PathName& path, bool append, size_t bufferSize, bool direct,
+                       size_t preallocate);
+
+    ~BufferedFileWriter();
+
+    void write(const void* data, size_t length);
+
+    /// Hands everything written so far to the operating system
+    void flush();
+
+    void report(std::ostream& s) const;
+
+private:  // methods
+    void submit();
+    void waitIdle();
+
+    void writeOut(int fd, const char* data, size_t length, off_t offset);
+
+    void run();
+
+private:  // members
+    const eckit::PathName path_;
+    const size_t bufferSize_;
+    const bool direct_;
+
+    int fd_ = -1;
+    int tailFd_ = -1;  // Without O_DIRECT, for the unaligned tail on flush
+
+    char* buffers_[2] = {nullptr, nullptr};
+    size_t current_ = 0;
+    size_t fill_ = 0;
+    off_t offset_ = 0;  // File position of the start of the current buffer
+
+    // State shared with the writing thread
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const char* pending_ = nullptr;
+    size_t pendingLength_ = 0;
+    off_t pendingOffset_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    IOStats stats_;
+    eckit::Timer timer_;
+
+    std::thread thread_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace multio
+
+#endif  // multio_BufferedFileWriter_H
@@ -14,12 +14,19 @@
 
 #include "multio/sink/DataSink.h"
 
+#include <cstring>
 #include <mutex>
 
+#include "eccodes.h"
+
 #include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/DataHandle.h"
 #include "eckit/log/JSON.h"
 #include "eckit/value/Value.h"
 
+#include "metkit/codes/CodesContent.h"
+
 #include "multio/LibMultio.h"
 
 namespace multio {
@@ -29,6 +36,48 @@ using eckit::Log;
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+class OwnedDataContent : public eckit::message::MessageContent {
+public:
+    OwnedDataContent(const void* data, size_t length) :
+        buffer_{static_cast<const char*>(data), length} {}
+
+private:
+    size_t length() const override { return buffer_.size(); }
+
+    const void* data() const override { return buffer_; }
+
+    void write(eckit::DataHandle& handle) const override {
+        if (handle.write(buffer_, buffer_.size()) != static_cast<long>(buffer_.size())) {
+            throw eckit::WriteError("OwnedDataContent: short write");
+        }
+    }
+
+    void print(std::ostream& os) const override {
+        os << "OwnedDataContent[size=" << buffer_.size() << "]";
+    }
+
+    eckit::Buffer buffer_;
+};
+
+}  // namespace
+
+eckit::message::Message owning_copy(const eckit::message::Message& msg) {
+    const void* data = msg.data();
+    size_t length = msg.length();
+
+    if (length >= 4 && std::memcmp(data, "GRIB", 4) == 0) {
+        codes_handle* h = codes_handle_new_from_message_copy(nullptr, data, length);
+        ASSERT(h);
+        return eckit::message::Message{new metkit::codes::CodesContent{h, true}};
+    }
+
+    return eckit::message::Message{new OwnedDataContent{data, length}};
+}
+
+//--------------------------------------------------------------------------------------------------
+
 DataSinkFactory& DataSinkFactory::instance() {
     static DataSinkFactory singleton;
     return singleton;
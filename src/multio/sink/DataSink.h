@@ -30,6 +30,13 @@ namespace multio {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Returns a message that owns a copy of the bytes of msg. Callers may build the messages they
+/// write over memory they reuse as soon as write() returns, so a sink that keeps a message beyond
+/// that must keep such a copy instead.
+eckit::message::Message owning_copy(const eckit::message::Message& msg);
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class DataSink {
 public:  // methods
     DataSink(const eckit::Configuration& config);
@@ -12,6 +12,9 @@
 /// @author Simon Smart
 /// @date Dec 2015
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <fstream>
 #include <iosfwd>
 
@@ -21,6 +24,8 @@
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/DataHandle.h"
 
+#include "multio/LibMultio.h"
+
 using namespace eckit;
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -28,7 +33,37 @@ using namespace eckit;
 namespace multio {
 
 FileSink::FileSink(const Configuration& config) :
-    DataSink(config), path_(config_.getString("path")), handle_(path_.fileHandle(false)) {
+    DataSink(config), path_(config_.getString("path")) {
+    if (config_.getBool("buffered", false) && config_.has("io-engine")) {
+        throw eckit::UserError("FileSink: 'buffered' and 'io-engine' cannot be combined", Here());
+    }
+
+    if (config_.getBool("buffered", false)) {
+        writer_.reset(new BufferedFileWriter{
+            path_, config_.getBool("append", false),
+            static_cast<size_t>(config_.getUnsigned("buffer-size", 64 * 1024 * 1024)),
+            config_.getBool("direct", false),
+            static_cast<size_t>(config_.getUnsigned("preallocate", 0))});
+        return;
+    }
+
+    if (config_.has("io-engine")) {
+        const bool append = config_.getBool("append", false);
+        fd_ = ::open(path_.localPath(), O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC), 0666);
+        if (fd_ < 0) {
+            throw eckit::CantOpenFile(std::string(path_));
+        }
+        if (append) {
+            offset_ = ::lseek(fd_, 0, SEEK_END);
+        }
+
+        engine_ = IOEngine::build(config_.getString("io-engine"),
+                                  static_cast<size_t>(config_.getUnsigned("io-depth", 64)),
+                                  static_cast<size_t>(config_.getUnsigned("io-threads", 4)));
+        return;
+    }
+
+    handle_.reset(path_.fileHandle(false));
     if (config_.getBool("append", false)) {
         handle_->openForAppend(0);
     }
@@ -38,21 +73,54 @@ FileSink::FileSink(const Configuration& config) :
 }
 
 FileSink::~FileSink() {
+    if (writer_) {
+        writer_.reset();
+        return;
+    }
+    if (engine_) {
+        engine_.reset();
+        ::close(fd_);
+        return;
+    }
     handle_->close();
 }
 
 void FileSink::write(eckit::message::Message msg) {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (writer_) {
+        writer_->write(msg.data(), msg.length());
+        return;
+    }
+    if (engine_) {
+        engine_->write(fd_, msg.data(), msg.length(), offset_);
+        offset_ += msg.length();
+        return;
+    }
     msg.write(*handle_);
 }
 
 void FileSink::flush() {
     eckit::Log::info() << "Flush is called..." << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (writer_) {
+        writer_->flush();
+        LOG_DEBUG_LIB(LibMultio) << *this << ": ";
+        writer_->report(eckit::Log::debug<LibMultio>());
+        return;
+    }
+    if (engine_) {
+        engine_->wait();
+        return;
+    }
     handle_->flush();
 }
 
 void FileSink::print(std::ostream& os) const {
-    os << "FileSink(path=" << path_ << ")";
+    os << "FileSink(path=" << path_ << (writer_ ? ", buffered" : "");
+    if (engine_) {
+        os << ", " << *engine_;
+    }
+    os << ")";
 }
 
 static DataSinkBuilder<FileSink> FileSinkFactorySingleton("file");
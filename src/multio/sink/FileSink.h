@@ -24,7 +24,9 @@
 
 #include "eckit/filesystem/PathName.h"
 
+#include "multio/sink/BufferedFileWriter.h"
 #include "multio/sink/DataSink.h"
+#include "multio/sink/IOEngine.h"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -34,6 +36,11 @@ class FileHandle;
 
 namespace multio {
 
+/// With `buffered: true`, messages are coalesced in buffers of `buffer-size` bytes and written
+/// in the background; `direct: true` adds O_DIRECT and `preallocate` reserves space up front.
+/// With `io-engine: uring` or `threads`, up to `io-depth` messages are copied to staging buffers
+/// and written asynchronously, and flush waits for them. The two modes cannot be combined.
+
 class FileSink final : public DataSink {
 public:
     explicit FileSink(const eckit::Configuration& config);
@@ -50,6 +57,12 @@ private:  // methods
 private:  // members
     eckit::PathName path_;
     std::unique_ptr<eckit::DataHandle> handle_;
+    std::unique_ptr<BufferedFileWriter> writer_;
+
+    std::unique_ptr<IOEngine> engine_;
+    int fd_ = -1;
+    off_t offset_ = 0;
+
     std::mutex mutex_;
 };
 
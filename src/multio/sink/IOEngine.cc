@@ -0,0 +1,447 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "multio/sink/IOEngine.h"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "multio/multio_config.h"
+
+#ifdef MULTIO_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace multio {
+
+namespace {
+
+struct WriteRequest {
+    int fd = -1;
+    std::vector<char> data;  // Staging copy; its capacity is reused by later writes
+    off_t offset = 0;
+    size_t done = 0;  // Bytes written so far
+
+    void assign(int fd, const void* data, size_t length, off_t offset) {
+        auto begin = static_cast<const char*>(data);
+        this->fd = fd;
+        this->data.assign(begin, begin + length);
+        this->offset = offset;
+        done = 0;
+    }
+
+    const char* next() const { return data.data() + done; }
+    size_t remaining() const { return data.size() - done; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class ThreadIOEngine final : public IOEngine {
+public:
+    ThreadIOEngine(size_t depth, size_t threads) : depth_{depth} {
+        for (size_t i = 0; i != threads; ++i) {
+            threads_.emplace_back(&ThreadIOEngine::run, this);
+        }
+    }
+
+    ~ThreadIOEngine() override {
+        try {
+            wait();
+        }
+        catch (const std::exception& e) {
+            eckit::Log::error() << *this << ": " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void write(int fd, const void* data, size_t length, off_t offset) override {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cv_.wait(lock, [this]() { return inFlight_ < depth_; });
+
+        WriteRequest request;
+        if (not spare_.empty()) {
+            request.data = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        request.assign(fd, data, length, offset);
+        queue_.push_back(std::move(request));
+        ++inFlight_;
+
+        cv_.notify_all();
+    }
+
+    void wait() override {
+        std::unique_lock<std::mutex> lock{mutex_};
+        cv_.wait(lock, [this]() { return inFlight_ == 0; });
+
+        if (error_) {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        while (true) {
+            cv_.wait(lock, [this]() { return stop_ || not queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+
+            auto request = std::move(queue_.front());
+            queue_.pop_front();
+
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                writeAll(request);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+
+            spare_.push_back(std::move(request.data));
+            if (error && not error_) {
+                error_ = error;
+            }
+            --inFlight_;
+            cv_.notify_all();
+        }
+    }
+
+    static void writeAll(WriteRequest& request) {
+        while (request.remaining() > 0) {
+            auto written = ::pwrite(request.fd, request.next(), request.remaining(),
+                                    request.offset + request.done);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw eckit::FailedSystemCall("pwrite", Here(), errno);
+            }
+            request.done += written;
+        }
+    }
+
+    void print(std::ostream& os) const override {
+        os << "IOEngine(threads=" << threads_.size() << ", depth=" << depth_ << ")";
+    }
+
+    const size_t depth_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<WriteRequest> queue_;
+    std::vector<std::vector<char>> spare_;  // Staging buffers of completed writes
+    size_t inFlight_ = 0;  // Queued and being written
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    std::vector<std::thread> threads_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#ifdef MULTIO_HAVE_IO_URING
+
+/// Drives the submission and completion rings directly, without liburing. Each write is
+/// submitted as it arrives and completions are reaped in batches, without a system call when
+/// they are already in the completion ring. Not thread-safe: the owning sink serialises calls.
+
+class UringIOEngine final : public IOEngine {
+public:
+    explicit UringIOEngine(size_t depth) : depth_{depth} {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, depth_, &params));
+        if (ringFd_ < 0) {
+            throw eckit::FailedSystemCall("io_uring_setup", Here(), errno);
+        }
+
+        try {
+            mapRings(params);
+        }
+        catch (...) {
+            unmapRings();
+            throw;
+        }
+
+        slots_.resize(depth_);
+        for (size_t slot = 0; slot != depth_; ++slot) {
+            free_.push_back(depth_ - 1 - slot);
+        }
+    }
+
+    ~UringIOEngine() override {
+        try {
+            wait();
+        }
+        catch (const std::exception& e) {
+            eckit::Log::error() << *this << ": " << e.what() << std::endl;
+        }
+        unmapRings();
+    }
+
+    void write(int fd, const void* data, size_t length, off_t offset) override {
+        while (free_.empty()) {
+            enter(1);
+            reap();
+        }
+
+        auto slot = free_.back();
+        free_.pop_back();
+        ++inFlight_;
+
+        slots_[slot].request.assign(fd, data, length, offset);
+
+        submit(slot);
+        enter(0);
+        reap();
+    }
+
+    void wait() override {
+        while (inFlight_ > 0) {
+            enter(1);
+            reap();
+        }
+
+        if (error_) {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // Each slot keeps its staging buffer, so steady-state writes do not allocate
+    struct Slot {
+        WriteRequest request;
+        struct iovec iov;  // Must stay valid until the write completes
+    };
+
+    void mapRings(const io_uring_params& params) {
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = map(sqRingSize_, IORING_OFF_SQ_RING);
+        cqRing_ = singleMap ? sqRing_ : map(cqRingSize_, IORING_OFF_CQ_RING);
+
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqesSize_, IORING_OFF_SQES));
+
+        auto sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    void* map(size_t size, off_t offset) {
+        auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_,
+                        offset);
+        if (p == MAP_FAILED) {
+            throw eckit::FailedSystemCall("mmap", Here(), errno);
+        }
+        return p;
+    }
+
+    void unmapRings() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != nullptr) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        ::close(ringFd_);
+    }
+
+    void submit(size_t slot) {
+        auto& entry = slots_[slot];
+        entry.iov.iov_base = const_cast<char*>(entry.request.next());
+        entry.iov.iov_len = entry.request.remaining();
+
+        // Only this thread produces submissions, so the tail can be read without ordering
+        const unsigned tail = *sqTail_;
+        const unsigned index = tail & sqMask_;
+
+        auto& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITEV;
+        sqe.fd = entry.request.fd;
+        sqe.addr = reinterpret_cast<unsigned long>(&entry.iov);
+        sqe.len = 1;
+        sqe.off = entry.request.offset + entry.request.done;
+        sqe.user_data = slot;
+
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        ++toSubmit_;
+    }
+
+    void enter(unsigned minComplete) {
+        const unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true) {
+            auto submitted = ::syscall(__NR_io_uring_enter, ringFd_, toSubmit_, minComplete, flags,
+                                       nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw eckit::FailedSystemCall("io_uring_enter", Here(), errno);
+            }
+            toSubmit_ -= static_cast<unsigned>(submitted);
+            return;
+        }
+    }
+
+    void reap() {
+        unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head) {
+            const auto& cqe = cqes_[head & cqMask_];
+            complete(static_cast<size_t>(cqe.user_data), cqe.res);
+        }
+
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    void complete(size_t slot, int result) {
+        auto& request = slots_[slot].request;
+
+        if (result < 0 && result != -EINTR && result != -EAGAIN) {
+            if (not error_) {
+                error_ = std::make_exception_ptr(
+                    eckit::FailedSystemCall("io_uring write", Here(), -result));
+            }
+        }
+        else {
+            request.done += static_cast<size_t>(std::max(result, 0));
+            if (request.remaining() > 0) {
+                // Short write: submit the rest with the next call into the kernel
+                submit(slot);
+                return;
+            }
+        }
+
+        free_.push_back(slot);
+        --inFlight_;
+    }
+
+    void print(std::ostream& os) const override { os << "IOEngine(uring, depth=" << depth_ << ")"; }
+
+    const size_t depth_;
+
+    int ringFd_ = -1;
+
+    void* sqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    void* cqRing_ = nullptr;
+    size_t cqRingSize_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::vector<Slot> slots_;
+    std::vector<size_t> free_;
+    size_t inFlight_ = 0;
+    unsigned toSubmit_ = 0;
+
+    std::exception_ptr error_;
+};
+
+#endif  // MULTIO_HAVE_IO_URING
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::unique_ptr<IOEngine> IOEngine::build(const std::string& name, size_t depth, size_t threads) {
+    depth = std::max<size_t>(depth, 1);
+    threads = std::max<size_t>(threads, 1);
+
+    if (name == "uring") {
+#ifdef MULTIO_HAVE_IO_URING
+        try {
+            return std::unique_ptr<IOEngine>{new UringIOEngine{depth}};
+        }
+        catch (const eckit::FailedSystemCall& e) {
+            // E.g. an older kernel, or io_uring disabled by a seccomp profile
+            eckit::Log::warning() << "io_uring is not available (" << e.what()
+                                  << "), writing from a thread pool instead" << std::endl;
+        }
+#else
+        eckit::Log::warning() << "multio was built without io_uring, writing from a thread pool instead"
+                              << std::endl;
+#endif
+    }
+    else if (name != "threads") {
+        throw eckit::UserError("Unknown I/O engine '" + name + "', expected 'uring' or 'threads'",
+                               Here());
+    }
+
+    return std::unique_ptr<IOEngine>{new ThreadIOEngine{depth, threads}};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace multio
@@ -0,0 +1,63 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_IOEngine_H
+#define multio_IOEngine_H
+
+#include <sys/types.h>
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "eckit/memory/NonCopyable.h"
+
+namespace multio {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Keeps several positioned writes in flight. The bytes of each write are copied into a staging
+/// buffer that is reused once the write completes, so callers may reuse their memory as soon as
+/// write() returns.
+///
+/// The "uring" engine submits writes through io_uring on Linux. The "threads" engine issues
+/// pwrite from a small pool of threads, and is used when io_uring is not available.
+/// Calls are serialised by the owning sink.
+
+class IOEngine : private eckit::NonCopyable {
+public:  // methods
+    /// name is "uring" or "threads". depth bounds the number of writes in flight.
+    static std::unique_ptr<IOEngine> build(const std::string& name, size_t depth,
+                                           size_t threads);
+
+    virtual ~IOEngine() = default;
+
+    /// Writes length bytes at offset. Blocks only while depth writes are in flight.
+    virtual void write(int fd, const void* data, size_t length, off_t offset) = 0;
+
+    /// Waits for every write submitted so far. The first error is rethrown here.
+    virtual void wait() = 0;
+
+private:  // methods
+    virtual void print(std::ostream& os) const = 0;
+
+    friend std::ostream& operator<<(std::ostream& os, const IOEngine& engine) {
+        engine.print(os);
+        return os;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace multio
+
+#endif  // multio_IOEngine_H
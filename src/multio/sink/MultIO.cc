@@ -16,7 +16,13 @@
 
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <string>
+#include <thread>
 
 #include "eckit/config/LocalConfiguration.h"
 #include "eckit/exception/Exceptions.h"
@@ -51,6 +57,176 @@ public:
 
 //--------------------------------------------------------------------------------------------------
 
+class MultIO::SinkWorker {
+public:
+    // written is called with the sequence number of each message once the sink is done with it,
+    // and whether the write failed
+    SinkWorker(std::shared_ptr<DataSink> sink, bool threaded, size_t queueSize,
+               std::function<void(size_t, bool)> written) :
+        sink_{std::move(sink)},
+        stats_{"MultIO sink " + std::to_string(sink_->id())},
+        queueSize_{queueSize},
+        written_{std::move(written)} {
+        if (threaded) {
+            thread_ = std::thread{&SinkWorker::run, this};
+        }
+    }
+
+    ~SinkWorker() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stop_ = true;
+            }
+            notEmpty_.notify_one();
+            thread_.join();
+        }
+    }
+
+    bool ready() {
+        std::lock_guard<std::mutex> lock{sinkMutex_};
+        return sink_->ready();
+    }
+
+    // A threaded worker keeps the message until it is written, so it must own its bytes
+    void write(eckit::message::Message message, size_t sequence) {
+        if (not thread_.joinable()) {
+            std::lock_guard<std::mutex> lock{sinkMutex_};
+            writeToSink(message);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            notFull_.wait(lock, [this]() { return queue_.size() < queueSize_; });
+            queue_.push_back(Request{std::move(message), sequence, false});
+        }
+        notEmpty_.notify_one();
+    }
+
+    // Queues a flush of the sink; wait() blocks until it has been executed
+    void startFlush() {
+        if (not thread_.joinable()) {
+            std::lock_guard<std::mutex> lock{sinkMutex_};
+            sink_->flush();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            queue_.push_back(Request{eckit::message::Message{}, 0, true});
+            ++flushRequested_;
+        }
+        notEmpty_.notify_one();
+    }
+
+    std::exception_ptr wait() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        flushed_.wait(lock, [this]() { return flushCompleted_ == flushRequested_; });
+
+        auto error = error_;
+        error_ = nullptr;
+        return error;
+    }
+
+    // Returns the first failure since the last call or wait(), without waiting
+    std::exception_ptr takeError() {
+        std::lock_guard<std::mutex> lock{mutex_};
+        auto error = error_;
+        error_ = nullptr;
+        return error;
+    }
+
+    void report(std::ostream& s) {
+        std::lock_guard<std::mutex> lock{sinkMutex_};
+        stats_.report(s);
+    }
+
+private:
+    struct Request {
+        eckit::message::Message message;
+        size_t sequence;
+        bool barrier;
+    };
+
+    // Call with sinkMutex_ held
+    void writeToSink(const eckit::message::Message& message) {
+        StatsTimer stTimer{timer_, std::bind(&IOStats::logWrite, &stats_, message.length(),
+                                             std::placeholders::_1)};
+        sink_->write(message);
+    }
+
+    void run() {
+        while (true) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                notEmpty_.wait(lock, [this]() { return stop_ || not queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            notFull_.notify_one();
+
+            bool failed = false;
+            try {
+                std::lock_guard<std::mutex> lock{sinkMutex_};
+                if (request.barrier) {
+                    sink_->flush();
+                }
+                else {
+                    writeToSink(request.message);
+                }
+            }
+            catch (...) {
+                failed = true;
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+            }
+
+            if (request.barrier) {
+                {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    ++flushCompleted_;
+                }
+                flushed_.notify_all();
+            }
+            else {
+                written_(request.sequence, failed);
+            }
+        }
+    }
+
+    std::shared_ptr<DataSink> sink_;
+    std::mutex sinkMutex_;
+
+    // Guarded by sinkMutex_
+    IOStats stats_;
+    eckit::Timer timer_;
+
+    const size_t queueSize_;
+    std::deque<Request> queue_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::condition_variable flushed_;
+
+    size_t flushRequested_ = 0;
+    size_t flushCompleted_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    std::function<void(size_t, bool)> written_;
+
+    std::thread thread_;
+};
+
+//--------------------------------------------------------------------------------------------------
+
 using namespace std::placeholders;
 
 MultIO::MultIO(const eckit::Configuration& config) :
@@ -69,15 +245,23 @@ MultIO::MultIO(const eckit::Configuration& config) :
         sink->setId(sinks_.size());
         sinks_.emplace_back(sink);
     }
+
+    threaded_ = sinks_.size() > 1 && config.getBool("parallel", true);
+    const auto queueSize = static_cast<size_t>(std::max(1L, config.getLong("queue-size", 64)));
+    for (const auto& sink : sinks_) {
+        workers_.emplace_back(
+            new SinkWorker{sink, threaded_, queueSize, std::bind(&MultIO::written, this, _1, _2)});
+    }
 }
 
-bool MultIO::ready() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+MultIO::~MultIO() {
+    // Stop the workers before the pending triggers they report to go away
+    workers_.clear();
+}
 
-    decltype(sinks_)::const_iterator it = sinks_.begin();
-    decltype(sinks_)::const_iterator end = sinks_.end();
-    for (; it != end; ++it) {
-        if (!(*it)->ready()) {
+bool MultIO::ready() const {
+    for (const auto& worker : workers_) {
+        if (!worker->ready()) {
             return false;
         }
     }
@@ -86,37 +270,136 @@ bool MultIO::ready() const {
 
 void MultIO::write(eckit::message::Message message) {
 
+    if (not threaded_) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& worker : workers_) {
+                worker->write(message, 0);
+            }
+        }
+
+        LOG_DEBUG_LIB(LibMultio) << "Trigger events for message " << message << std::endl;
+
+        std::lock_guard<std::mutex> lock(triggerMutex_);
+        trigger_.events(message);
+        return;
+    }
+
+    // The caller may reuse the memory behind message as soon as this returns. One copy is shared
+    // by all workers.
+    auto owned = owning_copy(message);
+
     std::lock_guard<std::mutex> lock(mutex_);
 
-    StatsTimer stTimer{timer_, std::bind(&IOStats::logWrite, &stats_, message.length(), _1)};
-    for (const auto& sink : sinks_) {
-        sink->write(message);
+    // Failures of earlier writes surface here or in the next flush, whichever comes first
+    std::exception_ptr error = takeTriggerError();
+    for (const auto& worker : workers_) {
+        auto e = worker->takeError();
+        if (e && not error) {
+            error = e;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    {
+        std::lock_guard<std::mutex> triggerLock(triggerMutex_);
+        pending_.push_back(Pending{owned, workers_.size(), false});
+    }
+    const auto sequence = nextSequence_++;
+    for (const auto& worker : workers_) {
+        worker->write(owned, sequence);
     }
+}
+
+void MultIO::written(size_t sequence, bool failed) {
+    std::lock_guard<std::mutex> lock(triggerMutex_);
+
+    ASSERT(sequence >= firstPending_ && sequence - firstPending_ < pending_.size());
+    auto& pending = pending_[sequence - firstPending_];
+    ASSERT(pending.remaining > 0);
+    --pending.remaining;
+    pending.failed = pending.failed || failed;
 
-    LOG_DEBUG_LIB(LibMultio) << "Trigger events for message " << message << std::endl;
+    // Triggers fire in the order the messages were written, once every sink has written them. A
+    // message that any sink failed to write fires none, as when writing without workers.
+    while (not pending_.empty() && pending_.front().remaining == 0) {
+        const auto& front = pending_.front();
+        if (front.failed) {
+            LOG_DEBUG_LIB(LibMultio) << "No events for message " << front.message
+                                     << ", which failed to write" << std::endl;
+        }
+        else {
+            LOG_DEBUG_LIB(LibMultio) << "Trigger events for message " << front.message
+                                     << std::endl;
+            // Called on a worker thread, so failures are passed on to the next write or flush
+            try {
+                trigger_.events(front.message);
+            }
+            catch (...) {
+                if (not triggerError_) {
+                    triggerError_ = std::current_exception();
+                }
+            }
+        }
+        pending_.pop_front();
+        ++firstPending_;
+    }
+}
 
-    trigger_.events(message);
+std::exception_ptr MultIO::takeTriggerError() {
+    std::lock_guard<std::mutex> lock(triggerMutex_);
+    auto error = triggerError_;
+    triggerError_ = nullptr;
+    return error;
 }
 
 void MultIO::trigger(const eckit::StringDict& metadata) const {
+    std::lock_guard<std::mutex> lock(triggerMutex_);
     trigger_.events(metadata);
 }
 
 void MultIO::flush() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        StatsTimer stTimer{timer_, std::bind(&IOStats::logFlush, &stats_, _1)};
 
-    StatsTimer stTimer{timer_, std::bind(&IOStats::logFlush, &stats_, _1)};
-    for (const auto& sink : sinks_) {
-        sink->flush();
+        // Flush all sinks concurrently, then join
+        for (const auto& worker : workers_) {
+            worker->startFlush();
+        }
+        for (const auto& worker : workers_) {
+            auto e = worker->wait();
+            if (e && not error) {
+                error = e;
+            }
+        }
+
+        // Every trigger of the messages written so far has fired by now
+        auto e = takeTriggerError();
+        if (e && not error) {
+            error = e;
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
     }
 }
 
 void MultIO::report(std::ostream& s) {
-    stats_.report(s);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.report(s);
+    }
+    for (const auto& worker : workers_) {
+        worker->report(s);
+    }
 }
 
 void MultIO::print(std::ostream& os) const {
-    std::lock_guard<std::mutex> lock(mutex_);
     os << "MultIO(";
     bool first = true;
     for (const auto& sink : sinks_) {
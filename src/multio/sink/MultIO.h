@@ -15,7 +15,10 @@
 #ifndef multio_MultIO_H
 #define multio_MultIO_H
 
+#include <deque>
+#include <exception>
 #include <iosfwd>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -33,11 +36,18 @@ namespace multio {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// With more than one sink, each sink gets its own worker thread and queue, so that writes to
+/// different sinks overlap while every sink still sees the messages in order. Queued messages are
+/// copies, and triggers fire for a message once all sinks have written it; a message that any
+/// sink failed to write fires none. The first failure of any sink is rethrown by the next write or
+/// flush, and a flush waits for all workers. Set `parallel: false` to write to the sinks one after
+/// the other on the calling thread.
+
 class MultIO final : public DataSink {
 public:
     explicit MultIO(const eckit::Configuration& config);
 
-    ~MultIO() override = default;
+    ~MultIO() override;
 
     bool ready() const override;
 
@@ -53,16 +63,44 @@ protected:  // methods
 
     void print(std::ostream&) const override;
 
+    // Called by the workers once a sink is done with the message with this sequence number
+    void written(size_t sequence, bool failed);
+
+    std::exception_ptr takeTriggerError();
+
 protected:  // members
 
+    class SinkWorker;
+
     IOStats stats_;
 
     std::vector<std::shared_ptr<DataSink>> sinks_;
 
+    std::vector<std::unique_ptr<SinkWorker>> workers_;
+
     Trigger trigger_;
 
+    bool threaded_;
+
+    // Messages queued to the workers whose triggers have not fired yet
+    struct Pending {
+        eckit::message::Message message;
+        size_t remaining;
+        bool failed;
+    };
+    std::deque<Pending> pending_;
+    size_t firstPending_ = 0;
+    size_t nextSequence_ = 0;
+
+    // Orders writes to the workers and guards the statistics; sinks are synchronised by their
+    // workers
     mutable std::mutex mutex_;
 
+    // Guards the triggers and pending_. Workers take it, so it must never be held while waiting
+    // on a worker.
+    mutable std::mutex triggerMutex_;
+    std::exception_ptr triggerError_;
+
     eckit::Timer timer_;
 
 private:  // methods
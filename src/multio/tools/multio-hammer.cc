@@ -169,7 +169,7 @@ std::vector<double>& global_test_field(const std::string& field_id, const size_t
         return test_fields[field_id];
     }
 
-    if (transport == "mpi" && new_random_data_each_run()) {
+    if ((transport == "mpi" || transport == "shm") && new_random_data_each_run()) {
         test_fields[field_id] =
             (root() == list_id) ? create_random_data(sz) : std::vector<double>(sz);
         comm().broadcast(test_fields[field_id], root());
@@ -195,6 +195,7 @@ eckit::LocalConfiguration test_configuration(const std::string& type) {
     eckit::Log::debug<multio::LibMultio>() << "Transport type: " << type << std::endl;
 
     std::map<std::string, std::string> configs = {{"mpi", "mpi-test-configuration"},
+                                                  {"shm", "shm-test-configuration"},
                                                   {"tcp", "tcp-test-configuration"},
                                                   {"thread", "thread-test-configuration"},
                                                   {"none", "no-transport-test-configuration"}};
@@ -261,6 +262,7 @@ private:
 
     long ensMember_ = 1;
     long sleep_ = 0;
+    size_t fieldSize_ = 29;
 
     eckit::LocalConfiguration config_;
 
@@ -306,6 +308,8 @@ MultioHammer::MultioHammer(int argc, char** argv) : multio::MultioTool(argc, arg
         new eckit::option::SimpleOption<size_t>("nbsteps", "Number of output time steps"));
     options_.push_back(new eckit::option::SimpleOption<size_t>("member", "Ensemble member"));
     options_.push_back(new eckit::option::SimpleOption<long>("sleep", "Seconds of simulated work per step"));
+    options_.push_back(
+        new eckit::option::SimpleOption<size_t>("fieldsize", "Number of points of each field"));
 }
 
 
@@ -321,6 +325,7 @@ void MultioHammer::init(const eckit::option::CmdArgs& args) {
     args.get("nbparams", paramCount_);
     args.get("member", ensMember_);
     args.get("sleep", sleep_);
+    args.get("fieldsize", fieldSize_);
 
     config_ =
         (configPath_.empty())
@@ -328,7 +333,7 @@ void MultioHammer::init(const eckit::option::CmdArgs& args) {
             : eckit::LocalConfiguration{eckit::YAMLConfiguration{eckit::PathName{configPath_}}};
 
     transportType_ = config_.getString("transport");
-    if (transportType_ == "mpi") {
+    if (transportType_ == "mpi" || transportType_ == "shm") {
         auto comm_size = eckit::mpi::comm(config_.getString("group").c_str()).size();
         if (comm_size != clientCount_ + serverCount_) {
             throw eckit::SeriousBug(
@@ -450,12 +455,12 @@ void MultioHammer::spawnClients(const PeerList& clientPeers,
 //---------------------------------------------------------------------------------------------------------------
 
 void MultioHammer::execute(const eckit::option::CmdArgs& args) {
-    field_size() = 29;
+    field_size() = fieldSize_;
 
     if (transportType_ == "none") {
         executePlans(args);
     }
-    if (transportType_ == "mpi") {
+    if (transportType_ == "mpi" || transportType_ == "shm") {
         executeMpi();
     }
     if (transportType_ == "tcp") {
@@ -475,7 +480,7 @@ bool MultioHammer::skipTest() {
         doTest = true;
     }
 
-    if (transportType_ == "mpi") {
+    if (transportType_ == "mpi" || transportType_ == "shm") {
         eckit::mpi::comm().barrier();
         doTest = (eckit::mpi::comm().rank() == root());
     }
@@ -517,8 +522,10 @@ void MultioHammer::testData() {
     }
 }
 
+// Also for the shared memory transport, which numbers clients and servers the same way
 void MultioHammer::executeMpi() {
-    std::shared_ptr<Transport> transport{TransportFactory::instance().build("mpi", config_)};
+    std::shared_ptr<Transport> transport{
+        TransportFactory::instance().build(transportType_, config_)};
 
     auto comm = config_.getString("group");
 
@@ -0,0 +1,127 @@
+
+#ifndef multio_util_ThreadPool_H
+#define multio_util_ThreadPool_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace multio {
+namespace util {
+
+// Fixed set of workers running indexed tasks. The calling thread takes part as worker 0, so a
+// pool of size one runs everything in place.
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t index, size_t worker)>;
+
+    explicit ThreadPool(size_t size) {
+        for (size_t worker = 1; worker < size; ++worker) {
+            threads_.emplace_back(&ThreadPool::work, this, worker);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool& rhs) = delete;
+    ThreadPool& operator=(const ThreadPool& rhs) = delete;
+
+    size_t size() const { return threads_.size() + 1; }
+
+    // Runs task(index, worker) for every index in [0, count) and returns when all have finished.
+    // The first exception thrown by a task is rethrown here.
+    void parallelFor(size_t count, const Task& task) {
+        if (count == 0) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            task_ = &task;
+            count_ = count;
+            next_ = 0;
+            error_ = nullptr;
+            running_ = threads_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+
+        runTasks(0);
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        done_.wait(lock, [this]() { return running_ == 0; });
+        task_ = nullptr;
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    void work(size_t worker) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock{mutex_};
+                start_.wait(lock, [this, seen]() { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+
+            runTasks(worker);
+
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (--running_ == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    void runTasks(size_t worker) {
+        for (size_t index = next_++; index < count_; index = next_++) {
+            try {
+                (*task_)(index, worker);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{mutex_};
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+
+    const Task* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    size_t running_ = 0;
+    size_t generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
+
+}  // namespace util
+}  // namespace multio
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+
+namespace multio {
+namespace util {
+
+namespace {
+
+uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// A dump may run while other threads record, so every field is atomic. An event being
+// overwritten during a dump may come out torn, which is acceptable for diagnostics.
+struct Event {
+    std::atomic<uint64_t> time{0};
+    std::atomic<const char*> what{nullptr};
+    std::atomic<uint64_t> arg0{0};
+    std::atomic<uint64_t> arg1{0};
+};
+
+struct Record {
+    uint64_t time;
+    size_t thread;
+    const char* what;
+    uint64_t arg0;
+    uint64_t arg1;
+
+    bool operator<(const Record& rhs) const { return time < rhs.time; }
+};
+
+}  // namespace
+
+struct Trace::Ring {
+    Ring(size_t size) :
+        events(size), thread{std::hash<std::thread::id>{}(std::this_thread::get_id())} {}
+
+    std::vector<Event> events;
+    std::atomic<size_t> next{0};  // Only written by the owning thread
+    const size_t thread;
+};
+
+Trace& Trace::instance() {
+    static Trace trace;
+    return trace;
+}
+
+Trace::Trace() :
+    level_{eckit::Resource<int>("multioTraceLevel;$MULTIO_TRACE_LEVEL", 0)},
+    ringSize_{eckit::Resource<size_t>("multioTraceBufferSize;$MULTIO_TRACE_BUFFER_SIZE", 4096)} {
+    ASSERT(ringSize_ > 0);
+}
+
+Trace::~Trace() {
+    std::string path = eckit::Resource<std::string>("multioTraceFile;$MULTIO_TRACE_FILE", "");
+    if (path.empty() || level_ == 0) {
+        return;
+    }
+
+    std::ofstream out{path};
+    if (out) {
+        dump(out);
+    }
+    else {
+        std::cerr << "Cannot write multio trace to " << path << std::endl;
+    }
+}
+
+Trace::Ring& Trace::localRing() {
+    // Rings are never removed, so the pointer stays valid for the life of the thread
+    thread_local Ring* ring = nullptr;
+    if (ring == nullptr) {
+        std::shared_ptr<Ring> created{new Ring{ringSize_}};
+        std::lock_guard<std::mutex> lock{mutex_};
+        rings_.push_back(created);
+        ring = created.get();
+    }
+    return *ring;
+}
+
+void Trace::record(const char* what, uint64_t arg0, uint64_t arg1) {
+    auto& ring = localRing();
+    auto next = ring.next.load(std::memory_order_relaxed);
+
+    auto& event = ring.events[next % ring.events.size()];
+    event.time.store(now(), std::memory_order_relaxed);
+    event.what.store(what, std::memory_order_relaxed);
+    event.arg0.store(arg0, std::memory_order_relaxed);
+    event.arg1.store(arg1, std::memory_order_relaxed);
+
+    ring.next.store(next + 1, std::memory_order_release);
+}
+
+void Trace::dump(std::ostream& os) const {
+    std::vector<Record> records;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (const auto& ring : rings_) {
+            auto next = ring->next.load(std::memory_order_acquire);
+            auto size = ring->events.size();
+            for (auto i = next > size ? next - size : 0; i != next; ++i) {
+                const auto& event = ring->events[i % size];
+                if (event.time.load(std::memory_order_relaxed) < clearedAt_) {
+                    continue;
+                }
+                records.push_back(Record{event.time.load(std::memory_order_relaxed), ring->thread,
+                                         event.what.load(std::memory_order_relaxed),
+                                         event.arg0.load(std::memory_order_relaxed),
+                                         event.arg1.load(std::memory_order_relaxed)});
+            }
+        }
+    }
+
+    std::stable_sort(records.begin(), records.end());
+
+    for (const auto& record : records) {
+        os << record.time << " " << record.thread << " " << (record.what ? record.what : "?")
+           << " " << record.arg0 << " " << record.arg1 << "\n";
+    }
+    os.flush();
+}
+
+void Trace::clear() {
+    clearedAt_ = now();
+}
+
+}  // namespace util
+}  // namespace multio
@@ -0,0 +1,99 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef multio_util_Trace_H
+#define multio_util_Trace_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "eckit/memory/NonCopyable.h"
+
+// Events above this level are compiled out
+#ifndef MULTIO_TRACE_MAX_LEVEL
+#define MULTIO_TRACE_MAX_LEVEL 2
+#endif
+
+namespace multio {
+namespace util {
+
+enum class TraceLevel : int
+{
+    Off = 0,
+    Info = 1,
+    Debug = 2
+};
+
+/// Tracing for the hot paths of the transports. Each thread records events into its own ring
+/// of "multioTraceBufferSize;$MULTIO_TRACE_BUFFER_SIZE" events, overwriting the oldest. Nothing
+/// is formatted until the rings are dumped, either with dump() or, if
+/// "multioTraceFile;$MULTIO_TRACE_FILE" is set, to that file when the process exits.
+///
+/// Recording is enabled up to the level given by "multioTraceLevel;$MULTIO_TRACE_LEVEL", which is
+/// off by default. A disabled event costs a load and a branch.
+
+class Trace : private eckit::NonCopyable {
+public:  // methods
+    static Trace& instance();
+
+    ~Trace();
+
+    bool enabled(TraceLevel level) const {
+        return static_cast<int>(level) <= level_.load(std::memory_order_relaxed);
+    }
+
+    void level(TraceLevel level) { level_.store(static_cast<int>(level)); }
+
+    /// what must be a string literal: only the pointer is kept
+    void record(const char* what, uint64_t arg0 = 0, uint64_t arg1 = 0);
+
+    /// Writes the events of all threads, oldest first
+    void dump(std::ostream& os) const;
+
+    /// Forgets all events recorded so far
+    void clear();
+
+private:  // methods
+    Trace();
+
+    struct Ring;
+
+    Ring& localRing();
+
+private:  // members
+    std::atomic<int> level_;
+    const size_t ringSize_;
+
+    // Events recorded before this time are not dumped
+    std::atomic<uint64_t> clearedAt_{0};
+
+    // Rings outlive their threads, so that events are not lost when a thread exits
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+};
+
+}  // namespace util
+}  // namespace multio
+
+#define MULTIO_TRACE(level, ...)                                                        \
+    do {                                                                                \
+        if (static_cast<int>(level) <= MULTIO_TRACE_MAX_LEVEL &&                        \
+            ::multio::util::Trace::instance().enabled(level)) {                         \
+            ::multio::util::Trace::instance().record(__VA_ARGS__);                      \
+        }                                                                               \
+    } while (false)
+
+#endif
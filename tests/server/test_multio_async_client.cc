@@ -0,0 +1,161 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/testing/Test.h"
+
+#include "multio/server/MultioClient.h"
+#include "multio/server/Transport.h"
+
+namespace multio {
+namespace test {
+
+using message::Message;
+using message::Peer;
+using server::MultioClient;
+using server::Transport;
+
+namespace {
+
+// What the transport built by the client has seen
+struct Sent {
+    std::mutex mutex;
+    std::vector<Message::Tag> tags;
+    std::set<std::thread::id> threads;
+};
+
+Sent& sent() {
+    static Sent s;
+    return s;
+}
+
+// Sends slowly, so that messages queue up in the client, and fails once "fail-after" messages
+// have been sent
+class SlowTransport final : public Transport {
+public:
+    SlowTransport(const eckit::Configuration& config) :
+        Transport(config), failAfter_{config.getUnsigned("fail-after", 1000000)} {}
+
+private:
+    Message receive() override { NOTIMP; }
+
+    void send(const Message& msg) override {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+        std::lock_guard<std::mutex> lock{sent().mutex};
+        if (sent().tags.size() == failAfter_) {
+            throw eckit::SeriousBug("Transport failure", Here());
+        }
+        sent().tags.push_back(msg.tag());
+        sent().threads.insert(std::this_thread::get_id());
+    }
+
+    Peer localPeer() const override { return Peer{"test", 0}; }
+
+    void print(std::ostream& os) const override { os << "SlowTransport()"; }
+
+    const size_t failAfter_;
+};
+
+server::TransportBuilder<SlowTransport> SlowTransportBuilder("test-slow");
+
+eckit::YAMLConfiguration clientConfiguration(size_t failAfter) {
+    return eckit::YAMLConfiguration{std::string{R"json({
+        "transport" : "test-slow",
+        "group" : "test",
+        "clientCount" : 1,
+        "serverCount" : 2,
+        "servers" : [ { "host" : "localhost", "ports" : [1, 2] } ],
+        "async" : true,
+        "async-queue-size" : 16,
+        "fail-after" : )json"} + std::to_string(failAfter) + "}"};
+}
+
+void sendFields(MultioClient& client, size_t count) {
+    for (size_t i = 0; i != count; ++i) {
+        message::Metadata md;
+        md.set("category", "test");
+        md.set("nemoParam", "sst");
+        md.set("param", "sst");
+        md.set("level", static_cast<long>(i));
+
+        std::vector<double> values(16, static_cast<double>(i));
+        eckit::Buffer field{reinterpret_cast<const char*>(values.data()),
+                            values.size() * sizeof(double)};
+        client.sendField(md, std::move(field));
+    }
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock{sent().mutex};
+    sent().tags.clear();
+    sent().threads.clear();
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("wait returns once everything handed over has been sent from the background") {
+    reset();
+
+    MultioClient client{clientConfiguration(1000000)};
+    client.openConnections();
+    sendFields(client, 100);
+    client.sendStepComplete();
+    client.wait();
+
+    std::lock_guard<std::mutex> lock{sent().mutex};
+    EXPECT(sent().tags.size() == 2 + 100 + 2);
+    EXPECT(sent().tags.front() == Message::Tag::Open);
+    EXPECT(sent().tags.back() == Message::Tag::StepComplete);
+
+    EXPECT(sent().threads.size() == 1);
+    EXPECT(sent().threads.count(std::this_thread::get_id()) == 0);
+}
+
+CASE("a failed send is rethrown by wait and by later sends") {
+    reset();
+
+    MultioClient client{clientConfiguration(10)};
+    client.openConnections();
+
+    // Depending on timing, the failure surfaces in a later send or in wait
+    auto sendAndWait = [&client]() {
+        sendFields(client, 40);
+        client.wait();
+    };
+    EXPECT_THROWS_AS(sendAndWait(), eckit::SeriousBug);
+
+    EXPECT_THROWS_AS(client.wait(), eckit::SeriousBug);
+    EXPECT_THROWS_AS(client.sendStepComplete(), eckit::SeriousBug);
+
+    std::lock_guard<std::mutex> lock{sent().mutex};
+    EXPECT(sent().tags.size() == 10);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace multio
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
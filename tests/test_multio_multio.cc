@@ -8,9 +8,14 @@
  * does it submit to any jurisdiction.
  */
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
+
+#include "eccodes.h"
 
 #include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
 #include "eckit/log/JSON.h"
 #include "eckit/testing/Test.h"
 #include "eckit/utils/Translator.h"
@@ -90,6 +95,23 @@ bool trigger_executed_correctly(const eckit::PathName& file, const std::vector<i
     return (expected == actual);
 }
 
+// Fails to write the messages of step 2
+class FailingSink final : public DataSink {
+public:
+    FailingSink(const eckit::Configuration& config) : DataSink(config) {}
+
+    void write(eckit::message::Message message) override {
+        if (message.getLong("step") == 2) {
+            throw eckit::SeriousBug("Failed to write step 2", Here());
+        }
+    }
+
+private:
+    void print(std::ostream& os) const override { os << "FailingSink()"; }
+};
+
+DataSinkBuilder<FailingSink> failingSinkBuilder("test-failing");
+
 }  // namespace
 
 //-----------------------------------------------------------------------------
@@ -162,6 +184,97 @@ CASE("test_multio_with_event_trigger") {
     }
 }
 
+CASE("test_multio_writes_to_sinks_in_parallel") {
+    TestFile file1{eckit::TmpFile().baseName()};
+    TestFile file2{eckit::TmpFile().baseName()};
+
+    ::unsetenv("MULTIO_CONFIG_TRIGGERS");
+
+    std::string sinks(R"json({
+                  "sinks" : [
+                    { "type" : "file", "path" : ")json" + file1.name() + R"json(" },
+                    { "type" : "file", "path" : ")json" + file2.name() + R"json(" }
+                  ]
+                }
+                )json");
+
+    eckit::YAMLConfiguration config(sinks);
+    MultIO mio{config};
+
+    // TestDataContent does not copy. The buffer is overwritten as soon as each write returns, as
+    // callers are free to do, so the workers must write copies.
+    std::string expected;
+    std::vector<char> buffer;
+    for (int i = 0; i != 100; ++i) {
+        std::string datum = "message " + std::to_string(i) + "\n";
+        expected += datum;
+
+        buffer.assign(datum.begin(), datum.end());
+        eckit::message::Message msg{new TestDataContent{buffer.data(), buffer.size()}};
+        mio.write(msg);
+
+        std::fill(buffer.begin(), buffer.end(), 'x');
+    }
+    mio.flush();
+
+    // Each sink receives every message, in order
+    EXPECT(file_content(file1.name()) == expected);
+    EXPECT(file_content(file2.name()) == expected);
+}
+
+CASE("test_multio_fires_no_triggers_for_failed_writes") {
+    TestFile triggers{eckit::TmpFile().baseName()};
+    TestFile file{eckit::TmpFile().baseName()};
+
+    const int jobId = 345;
+    std::string tconf = R"json({
+            "triggers" : [
+              { "type" : "MetadataChange",
+                "file" : ")json" + std::string(triggers.name().baseName()) + R"json(",
+                "key" : "step",
+                "values" : [0, 1, 2],
+                "info" : { "job" : )json" + std::to_string(jobId) + R"json(,
+                           "job_name" : "epsnemo"
+                }
+              }
+            ]
+          })json";
+    ::setenv("MULTIO_CONFIG_TRIGGERS", tconf.c_str(), 1);
+
+    std::string sinks(R"json({
+                  "sinks" : [
+                    { "type" : "file", "path" : ")json" + file.name() + R"json(" },
+                    { "type" : "test-failing" }
+                  ]
+                }
+                )json");
+
+    eckit::YAMLConfiguration config(sinks);
+    {
+        MultIO mio{config};
+
+        // Queued messages are owned copies, so triggers need metadata that survives the copy
+        codes_handle* h = codes_grib_handle_new_from_samples(nullptr, "GRIB2");
+        EXPECT(h != nullptr);
+        for (long step = 0; step != 3; ++step) {
+            CODES_CHECK(codes_set_long(h, "step", step), NULL);
+
+            const void* data = nullptr;
+            size_t length = 0;
+            CODES_CHECK(codes_get_message(h, &data, &length), NULL);
+            mio.write(eckit::message::Message{new TestDataContent{data, length}});
+        }
+        codes_handle_delete(h);
+
+        EXPECT_THROWS_AS(mio.flush(), eckit::SeriousBug);
+    }  // mio is destroyed
+
+    ::unsetenv("MULTIO_CONFIG_TRIGGERS");
+
+    // Step 2 was not persisted by every sink: had it fired, step 1 would be followed by step 2
+    EXPECT(trigger_executed_correctly(triggers.name(), {0, 1}, jobId));
+}
+
 //-----------------------------------------------------------------------------
 
 }  // namespace test
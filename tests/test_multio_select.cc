@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/testing/Test.h"
+
+#include "multio/action/Action.h"
+#include "multio/message/Message.h"
+
+namespace multio {
+namespace test {
+
+using action::Action;
+using message::Message;
+using message::Metadata;
+using message::Peer;
+
+namespace {
+
+std::vector<std::string>& collected() {
+    static std::vector<std::string> entries;
+    return entries;
+}
+
+// Records the name and level of every message that reaches it
+class Collect final : public Action {
+public:
+    explicit Collect(const eckit::Configuration& config) : Action{config} {}
+
+    void execute(Message msg) const override {
+        collected().push_back(msg.name() + ":" + std::to_string(msg.metadata().getLong("level")));
+    }
+
+private:
+    void print(std::ostream& os) const override { os << "Collect()"; }
+};
+
+action::ActionBuilder<Collect> CollectBuilder("test-collect");
+
+std::unique_ptr<Action> makeSelect(const std::string& where) {
+    eckit::YAMLConfiguration config{std::string{R"json({
+        "type" : "Select",
+        "match" : "field",
+        "fields" : [ "sst", "ssh" ],
+        "where" : )json"} + where + R"json(,
+        "next" : { "type" : "test-collect" }
+    })json"};
+    return std::unique_ptr<Action>{
+        action::ActionFactory::instance().build(config.getString("type"), config)};
+}
+
+Message field(const std::string& name, long level, const std::string& stream = "oper") {
+    Metadata md;
+    md.set("name", name);
+    md.set("category", "ocean-2d");
+    md.set("level", level);
+    md.set("stream", stream);
+    return Message{Message::Header{Message::Tag::Field, Peer{}, Peer{}, std::move(md)}};
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Select passes fields whose key lies within an inclusive range") {
+    collected().clear();
+    auto select = makeSelect(R"json([ { "key" : "level", "range" : [2, 4] } ])json");
+
+    for (long level = 1; level != 6; ++level) {
+        select->execute(field("sst", level));
+    }
+    select->execute(field("sss", 3));
+
+    EXPECT(collected() == (std::vector<std::string>{"sst:2", "sst:3", "sst:4"}));
+}
+
+CASE("Select passes fields whose key takes one of the values") {
+    collected().clear();
+    auto select = makeSelect(R"json([ { "key" : "stream", "values" : ["oper", "wave"] } ])json");
+
+    select->execute(field("sst", 1, "oper"));
+    select->execute(field("ssh", 2, "enfo"));
+    select->execute(field("ssh", 3, "wave"));
+
+    EXPECT(collected() == (std::vector<std::string>{"sst:1", "ssh:3"}));
+}
+
+CASE("Select requires every condition and drops fields without the key") {
+    collected().clear();
+    auto select = makeSelect(R"json([ { "key" : "level", "range" : [1, 10] },
+                                      { "key" : "stream", "values" : ["oper"] },
+                                      { "key" : "member", "values" : ["1"] } ])json");
+
+    select->execute(field("sst", 1));
+    EXPECT(collected().empty());
+}
+
+CASE("Select rejects a range that is not [lower, upper]") {
+    EXPECT_THROWS_AS(makeSelect(R"json([ { "key" : "level", "range" : [4, 2] } ])json"),
+                     eckit::UserError);
+    EXPECT_THROWS_AS(makeSelect(R"json([ { "key" : "level", "range" : [1, 2, 3] } ])json"),
+                     eckit::UserError);
+}
+
+CASE("A field without a name fails when the name is asked for") {
+    Metadata md;
+    md.set("category", "ocean-2d");
+    Message msg{Message::Header{Message::Tag::Field, Peer{}, Peer{}, std::move(md)}};
+
+    EXPECT(msg.category() == "ocean-2d");
+    EXPECT_THROWS(msg.name());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace multio
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,175 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "eccodes.h"
+
+#include "eckit/testing/Test.h"
+
+#include "multio/action/SimplePacking.h"
+
+namespace multio {
+namespace test {
+
+using action::SimplePacking;
+
+namespace {
+
+std::vector<double> make_values(size_t count, double offset, double amplitude) {
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = offset + amplitude * std::sin(0.37 * i) * std::cos(0.011 * i * i);
+    }
+    return values;
+}
+
+// Encodes the values with ecCodes and checks that the native sections 5 and 7 are identical
+void compare_with_eccodes(long bitsPerValue, double offset, double amplitude) {
+    codes_handle* h = codes_grib_handle_new_from_samples(nullptr, "GRIB2");
+    EXPECT(h != nullptr);
+
+    size_t count = 0;
+    CODES_CHECK(codes_get_size(h, "values", &count), NULL);
+    auto values = make_values(count, offset, amplitude);
+
+    CODES_CHECK(codes_set_long(h, "bitsPerValue", bitsPerValue), NULL);
+    CODES_CHECK(codes_set_double_array(h, "values", values.data(), count), NULL);
+
+    long binaryScaleFactor = 0;
+    long decimalScaleFactor = 0;
+    double referenceValue = 0;
+    long section5 = 0;
+    long section7 = 0;
+    CODES_CHECK(codes_get_long(h, "binaryScaleFactor", &binaryScaleFactor), NULL);
+    CODES_CHECK(codes_get_long(h, "decimalScaleFactor", &decimalScaleFactor), NULL);
+    CODES_CHECK(codes_get_double(h, "referenceValue", &referenceValue), NULL);
+    CODES_CHECK(codes_get_long(h, "offsetSection5", &section5), NULL);
+    CODES_CHECK(codes_get_long(h, "offsetSection7", &section7), NULL);
+
+    const void* message = nullptr;
+    size_t length = 0;
+    CODES_CHECK(codes_get_message(h, &message, &length), NULL);
+    auto bytes = static_cast<const unsigned char*>(message);
+
+    SimplePacking packing{bitsPerValue};
+    EXPECT(packing.computeParameters(values.data(), count));
+
+    EXPECT_EQUAL(packing.binaryScaleFactor(), binaryScaleFactor);
+    EXPECT_EQUAL(packing.decimalScaleFactor(), decimalScaleFactor);
+    EXPECT_EQUAL(packing.referenceValue(), referenceValue);
+    EXPECT_EQUAL(section7 + 5 + packing.packedLength(count) + 4, length);
+
+    std::vector<unsigned char> section(20, 0);
+    std::memcpy(section.data(), bytes + section5, section.size());
+    packing.encodeSection5(section.data());
+    EXPECT(std::memcmp(section.data(), bytes + section5, section.size()) == 0);
+
+    std::vector<unsigned char> data(packing.packedLength(count));
+    packing.pack(values.data(), count, data.data());
+    EXPECT(std::memcmp(data.data(), bytes + section7 + 5, data.size()) == 0);
+
+    codes_handle_delete(h);
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Simple packing of byte-aligned values") {
+    std::vector<double> values{0.0, 1.0, 2.0, 3.0};
+
+    SimplePacking packing{16};
+    EXPECT(packing.computeParameters(values.data(), values.size()));
+    EXPECT_EQUAL(packing.referenceValue(), 0.0);
+    EXPECT_EQUAL(packing.binaryScaleFactor(), -14);
+    EXPECT_EQUAL(packing.decimalScaleFactor(), 0);
+
+    std::vector<unsigned char> data(packing.packedLength(values.size()));
+    EXPECT_EQUAL(data.size(), 8);
+    packing.pack(values.data(), values.size(), data.data());
+    EXPECT(data == (std::vector<unsigned char>{0x00, 0x00, 0x40, 0x00, 0x80, 0x00, 0xc0, 0x00}));
+
+    std::vector<unsigned char> section(20, 0);
+    packing.encodeSection5(section.data());
+    EXPECT(std::vector<unsigned char>(section.begin() + 11, section.end()) ==
+           (std::vector<unsigned char>{0x00, 0x00, 0x00, 0x00, 0x80, 0x0e, 0x00, 0x00, 0x10}));
+}
+
+CASE("Simple packing of values that straddle bytes") {
+    std::vector<double> values{0.0, 1.0, 2.0, 3.0};
+
+    SimplePacking packing{12};
+    EXPECT(packing.computeParameters(values.data(), values.size()));
+    EXPECT_EQUAL(packing.binaryScaleFactor(), -10);
+
+    std::vector<unsigned char> data(packing.packedLength(values.size()));
+    EXPECT_EQUAL(data.size(), 6);
+    packing.pack(values.data(), values.size(), data.data());
+    EXPECT(data == (std::vector<unsigned char>{0x00, 0x04, 0x00, 0x80, 0x0c, 0x00}));
+}
+
+CASE("The maximum packs into bitsPerValue bits although the reference lies below the minimum") {
+    // Single precision rounds the minimum down to 1000000.0, so the scaled maximum is 255.0 above
+    // the reference value in the first section and 255.52 in the second
+    SECTION("Range landing exactly on the largest integer") {
+        std::vector<double> values{1000000.05, 1000255.0};
+
+        SimplePacking packing{8};
+        EXPECT(packing.computeParameters(values.data(), values.size()));
+        EXPECT_EQUAL(packing.referenceValue(), 1000000.0);
+        EXPECT_EQUAL(packing.binaryScaleFactor(), 0);
+        EXPECT_EQUAL(packing.decimalScaleFactor(), 0);
+
+        std::vector<unsigned char> data(packing.packedLength(values.size()));
+        packing.pack(values.data(), values.size(), data.data());
+        EXPECT(data == (std::vector<unsigned char>{0x00, 0xff}));
+    }
+
+    SECTION("Range from the reference value beyond the largest integer") {
+        std::vector<double> values{1000000.05, 1000255.52};
+
+        SimplePacking packing{8};
+        EXPECT(packing.computeParameters(values.data(), values.size()));
+        EXPECT_EQUAL(packing.referenceValue(), 1000000.0);
+        EXPECT_EQUAL(packing.binaryScaleFactor(), 1);
+
+        std::vector<unsigned char> data(packing.packedLength(values.size()));
+        packing.pack(values.data(), values.size(), data.data());
+        EXPECT(data == (std::vector<unsigned char>{0x00, 0x80}));
+    }
+}
+
+CASE("Constant fields are left to ecCodes") {
+    std::vector<double> values(10, 273.15);
+
+    SimplePacking packing{16};
+    EXPECT(not packing.computeParameters(values.data(), values.size()));
+}
+
+CASE("Simple packing is identical to ecCodes") {
+    SECTION("Sea surface temperature, 16 bits") { compare_with_eccodes(16, 285.0, 15.0); }
+    SECTION("Sea surface height, 12 bits") { compare_with_eccodes(12, -0.3, 1.2); }
+    SECTION("Negative values, 24 bits") { compare_with_eccodes(24, -1000.0, 250.0); }
+    SECTION("Small range, 10 bits") { compare_with_eccodes(10, 35.0, 1e-4); }
+    SECTION("Coarse field, 8 bits") { compare_with_eccodes(8, 0.0, 50.0); }
+    SECTION("Fine field, 32 bits") { compare_with_eccodes(32, 101325.0, 5000.0); }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace multio
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
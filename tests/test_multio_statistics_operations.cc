@@ -0,0 +1,110 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "multio/action/Operation.h"
+#include "multio/action/Period.h"
+#include "multio/action/RollingMean.h"
+
+namespace multio {
+namespace test {
+
+using action::Average;
+using action::DateTimePeriod;
+using action::RollingMean;
+
+CASE("Merged partial averages equal the average over the whole period") {
+    const std::vector<std::vector<double>> fields{{1., 2.}, {3., 4.}, {5., 6.}, {7., 8.}};
+
+    Average whole{"average", 2};
+    for (const auto& fld : fields) {
+        whole.update(fld.data(), 2);
+    }
+
+    Average first{"average", 2};
+    first.update(fields[0].data(), 2);
+    first.update(fields[1].data(), 2);
+
+    Average second{"average", 2};
+    second.update(fields[2].data(), 2);
+    second.update(fields[3].data(), 2);
+
+    Average merged{"average", 2};
+    merged.merge(first);
+    merged.merge(second);
+
+    EXPECT(merged.count() == 4);
+    EXPECT(merged.compute() == whole.compute());
+}
+
+CASE("Merging different operations is rejected") {
+    action::Minimum minimum{"minimum", 2};
+    action::Maximum maximum{"maximum", 2};
+    EXPECT_THROWS(minimum.merge(maximum));
+}
+
+CASE("Rolling mean drops the oldest period once the window is full") {
+    RollingMean rolling{2, 1};
+
+    auto push = [&rolling](double val, long start, long end) {
+        Average partial{"average", 1};
+        partial.update(&val, 1);
+        rolling.push(partial, start, end);
+    };
+
+    push(1., 0, 24);
+    EXPECT(not rolling.full());
+
+    push(3., 24, 48);
+    EXPECT(rolling.full());
+    EXPECT(rolling.compute()[0] == 2.);
+    EXPECT(rolling.stepRange() == "0-48");
+
+    push(7., 48, 72);
+    EXPECT(rolling.compute()[0] == 5.);
+    EXPECT(rolling.stepRange() == "24-72");
+}
+
+CASE("A period includes steps up to one second past its end") {
+    const eckit::DateTime start{eckit::Date{20261001}, eckit::Time{0}};
+
+    SECTION("Period given by its duration") {
+        DateTimePeriod period{start, eckit::Second{3600}};
+        EXPECT(period.isWithin(0));
+        EXPECT(period.isWithin(3600));
+        EXPECT(period.isWithin(3601));
+        EXPECT(not period.isWithin(3602));
+    }
+
+    SECTION("Period given by its end") {
+        DateTimePeriod period{start, start + eckit::Second{3600}};
+        EXPECT(period.isWithin(3600));
+        EXPECT(period.isWithin(3601));
+        EXPECT(not period.isWithin(3602));
+    }
+
+    SECTION("Period after a reset") {
+        DateTimePeriod period{start, eckit::Second{3600}};
+        period.reset(3600);
+        EXPECT(period.isWithin(7200));
+        EXPECT(period.isWithin(7201));
+        EXPECT(not period.isWithin(7202));
+    }
+}
+
+}  // namespace test
+}  // namespace multio
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eckit/testing/Test.h"
+
+#include "multio/util/Trace.h"
+
+namespace multio {
+namespace test {
+
+using util::Trace;
+using util::TraceLevel;
+
+namespace {
+
+size_t countLines(const std::string& text, const std::string& what) {
+    std::istringstream in{text};
+    size_t count = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        count += line.find(" " + what + " ") != std::string::npos ? 1 : 0;
+    }
+    return count;
+}
+
+std::string dump() {
+    std::ostringstream os;
+    Trace::instance().dump(os);
+    return os.str();
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Events are recorded only up to the enabled level") {
+    Trace::instance().clear();
+    Trace::instance().level(TraceLevel::Info);
+
+    MULTIO_TRACE(TraceLevel::Info, "info-event", 1, 2);
+    MULTIO_TRACE(TraceLevel::Debug, "debug-event", 3, 4);
+
+    auto text = dump();
+    EXPECT(countLines(text, "info-event") == 1);
+    EXPECT(countLines(text, "debug-event") == 0);
+    EXPECT(text.find("info-event 1 2") != std::string::npos);
+
+    Trace::instance().level(TraceLevel::Off);
+    MULTIO_TRACE(TraceLevel::Info, "info-event", 5, 6);
+    EXPECT(countLines(dump(), "info-event") == 1);
+}
+
+CASE("Each thread keeps its latest events") {
+    Trace::instance().clear();
+    Trace::instance().level(TraceLevel::Debug);
+
+    const size_t count = 10000;
+    auto work = [count]() {
+        for (size_t i = 0; i != count; ++i) {
+            MULTIO_TRACE(TraceLevel::Debug, "thread-event", i);
+        }
+    };
+    std::thread first{work};
+    std::thread second{work};
+    first.join();
+    second.join();
+
+    // Rings hold 4096 events by default
+    auto text = dump();
+    EXPECT(countLines(text, "thread-event") == 2 * 4096);
+    EXPECT(text.find("thread-event 9999 0") != std::string::npos);
+    EXPECT(text.find("thread-event 0 0") == std::string::npos);
+
+    Trace::instance().level(TraceLevel::Off);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace multio
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}